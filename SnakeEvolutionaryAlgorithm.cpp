@@ -29,32 +29,39 @@
  */
 
 #include <iostream>
+#include <cstdlib>
+#include <string>
 #include "game.h"
+#include "decisionservice.h"
 #include "evolutionaryframework.h"
+#include "genomelibrary.h"
+#include "optimizerbenchmark.h"
+#include "processpool.h"
+#include "runconfig.h"
+#include "searchbenchmark.h"
+#include "snapshotring.h"
+#include "sweep.h"
+#include "tournament.h"
 using namespace std;
 
-int main()
+int main(int argc, char* argv[])
 {
+	//Worker processes started by a process pool only play the games they
+	//are sent
+	if(argc == 3 && string(argv[1]) == "--worker")
+		return run_process_worker(atoi(argv[2]));
+
 	//Note: Larger values for turn cutoffs improve genome performance
 	//over time but take longer to process generations
 
-	//The number of turns at which the fitness test cuts off
-	//a genome's game
-	const int TEST_TURNS = 500;
-	//The number of turns the fittest genome is allowed to
-	//play while the game is displayed after the last evolution
-	const int END_TURNS = 1000;
-	//The number of milliseconds each state of the fittest
-	//genome's game is displayed for after the last evolution
-	const int DISPLAY_DELAY = 100;
-
-	//srand seeded at a constant to create deterministic testing conditions
-	srand(5);
+	//The turn cutoffs, display delay and evolution parameters are held in
+	//the run settings and can be changed without recompiling
+	run_config config;
 
 	/*//Begin by loading the fittest genome from the previous run and viewing a game
 	genome test_g;
 	test_g.load_from_file();
-	test_g.play_game(true, END_TURNS, DISPLAY_DELAY);
+	test_g.play_game(true, config.END_TURNS, config.DISPLAY_DELAY);
 	test_g.display();
 	cin.ignore();
 	*/
@@ -64,30 +71,362 @@ int main()
 	const char* EXAMPLE_1 = "genomeExamples/genome_1500turns_30pop_40gen.txt";
 	const char* EXAMPLE_2 = "genomeExamples/genome_2000turns_30pop_20gen.txt";
 	test_g.load_from_file(EXAMPLE_2);
-	test_g.play_game(true, END_TURNS, DISPLAY_DELAY);
+	test_g.play_game(true, config.END_TURNS, config.DISPLAY_DELAY);
 	test_g.display();
 	cin.ignore();
 	*/
 
-	evolution test_e;
+	//Command line options, applied in order
+	//--config FILE         reads settings from a file of NAME = value lines
+	//--set NAME=VALUE      changes a single setting
+	//--sweep FILE          evolves every combination of the comma separated
+	//                      values in FILE concurrently and prints a table
+	//--play [genome file]  views a single game of a saved genome. Each move's
+	//                      search is split across a small thread pool.
+	//--batch               plays each generation's games in a lockstep batch
+	//                      simulation instead of one game object per task
+	//--steady              evolves a continuously ranked population with
+	//                      no generation barrier
+	//--map X Y             sets the map size, up to 256 by 256 tiles
+	//--import LIB FILES    adds text genome files to the genome library LIB
+	//--archive LIB         adds the fittest genome of every generation of
+	//                      the run to the genome library LIB
+	//--tournament M FILES  plays every genome in FILES, which are genome
+	//                      files or libraries, on the same M seeds and
+	//                      ranks them
+	//--top N               the number of genomes a tournament takes from
+	//                      the top of each library
+	//--serve GENOME [SOCKET]
+	//                      answers action requests with a genome, reading
+	//                      the standard input or a Unix domain socket
+	//--client SOCKET       plays a game with actions from a decision service
+	//--publish NAME        publishes each generation to the shared memory
+	//                      snapshot ring NAME
+	//--view NAME           shows the run publishing to NAME, replaying its
+	//                      champions at DISPLAY_DELAY per turn
+	//--optimizer-benchmark TARGET [RUNS]
+	//                      counts the games the genetic algorithm and CMA-ES
+	//                      need to reach the fitness TARGET
+	//--search-benchmark [genome file]
+	//                      measures the nodes per second of the recursive
+	//                      and compiled searches at depths 1 to 4
+	//--batch-check         evolves with the threaded fitness test and the
+	//                      batch simulation and checks every generation's
+	//                      sorted fitness is the same
+	bool play = false;
+	const char* play_file = "last_best_genome.txt";
+	const char* sweep_file = nullptr;
+	const char* archive_file = nullptr;
+	tournament test_t;
+	bool run_tournament = false;
+	vector<const char*> tournament_files;
+	const char* serve_file = nullptr;
+	const char* serve_socket = nullptr;
+	const char* client_socket = nullptr;
+	const char* publish_name = nullptr;
+	const char* view_name = nullptr;
+	const char* benchmark_file = nullptr;
+	optimizer_benchmark test_o;
+	bool run_optimizer_benchmark = false;
+	bool batch_check = false;
+	for(int i = 1; i < argc; i++)
+	{
+		string option = argv[i];
+		string name;
+		string value;
+		if(option == "--play")
+		{
+			play = true;
+			if(i + 1 < argc && argv[i + 1][0] != '-')
+				play_file = argv[++i];
+		}
+		else if(option == "--batch")
+			config.BATCH_SIMULATION = 1;
+		else if(option == "--batch-check")
+			batch_check = true;
+		else if(option == "--steady")
+			config.STEADY_STATE = 1;
+		else if(option == "--map" && i + 2 < argc)
+		{
+			config.MAP_X_LIMIT = atoi(argv[i + 1]);
+			config.MAP_Y_LIMIT = atoi(argv[i + 2]);
+			i += 2;
+		}
+		else if(option == "--config" && i + 1 < argc)
+		{
+			if(!config.load_from_file(argv[++i]))
+				return 1;
+		}
+		else if(option == "--set" && i + 1 < argc)
+		{
+			if(!split_setting(argv[++i], name, value) || !config.set(name, value))
+			{
+				cout << "Invalid setting " << argv[i] << endl;
+				return 1;
+			}
+		}
+		else if(option == "--sweep" && i + 1 < argc)
+			sweep_file = argv[++i];
+		else if(option == "--import" && i + 1 < argc)
+		{
+			const char* library_file = argv[++i];
+			vector<const char*> text_files;
+			while(i + 1 < argc && argv[i + 1][0] != '-')
+				text_files.push_back(argv[++i]);
+			int imported = genome_library::import_text(library_file, text_files);
+			cout << "Imported " << imported << " of " << text_files.size() << " genomes into " << library_file << endl;
+			return imported == (int)text_files.size() ? 0 : 1;
+		}
+		else if(option == "--archive" && i + 1 < argc)
+			archive_file = argv[++i];
+		else if(option == "--tournament" && i + 1 < argc)
+		{
+			run_tournament = true;
+			test_t.SEED_COUNT = atoi(argv[++i]);
+			while(i + 1 < argc && argv[i + 1][0] != '-')
+				tournament_files.push_back(argv[++i]);
+		}
+		else if(option == "--top" && i + 1 < argc)
+			test_t.LIBRARY_ENTRANTS = atoi(argv[++i]);
+		else if(option == "--serve" && i + 1 < argc)
+		{
+			serve_file = argv[++i];
+			if(i + 1 < argc && argv[i + 1][0] != '-')
+				serve_socket = argv[++i];
+		}
+		else if(option == "--client" && i + 1 < argc)
+			client_socket = argv[++i];
+		else if(option == "--publish" && i + 1 < argc)
+			publish_name = argv[++i];
+		else if(option == "--view" && i + 1 < argc)
+			view_name = argv[++i];
+		else if(option == "--optimizer-benchmark" && i + 1 < argc)
+		{
+			run_optimizer_benchmark = true;
+			config.TARGET_FITNESS = atoi(argv[++i]);
+			if(i + 1 < argc && argv[i + 1][0] != '-')
+				test_o.RUNS = atoi(argv[++i]);
+		}
+		else if(option == "--search-benchmark")
+		{
+			benchmark_file = "last_best_genome.txt";
+			if(i + 1 < argc && argv[i + 1][0] != '-')
+				benchmark_file = argv[++i];
+		}
+		else
+		{
+			cout << "Unknown option " << option << endl;
+			return 1;
+		}
+	}
+
+	if(!config.validate())
+		return 1;
+	if(!state::set_map_size(config.MAP_X_LIMIT, config.MAP_Y_LIMIT))
+	{
+		cout << "Unsupported map size " << config.MAP_X_LIMIT << "x" << config.MAP_Y_LIMIT << endl;
+		return 1;
+	}
+
+	//The game generator is seeded at a constant to create deterministic
+	//testing conditions. Breeding is seeded from the same setting.
+	seed_game_rand(config.SEED);
 
-	test_e.initialize();
+	if(sweep_file != nullptr)
+	{
+		sweep test_s;
+		test_s.base = config;
+		if(!test_s.load_from_file(sweep_file))
+			return 1;
+		vector<run_config> configs = test_s.configurations();
+		for(unsigned int i = 0; i < configs.size(); i++)
+		{
+			if(!configs[i].validate())
+				return 1;
+		}
+		test_s.run();
+		return 0;
+	}
+
+	if(view_name != nullptr)
+	{
+		snapshot_viewer viewer;
+		return viewer.run(view_name, config.DISPLAY_DELAY) ? 0 : 1;
+	}
+
+	if(serve_file != nullptr)
+	{
+		//Replies to standard input requests go to the standard output, so
+		//messages printed while loading are moved to the standard error
+		genome server_g;
+		streambuf* output = cout.rdbuf(cerr.rdbuf());
+		bool loaded = server_g.load_from_file(serve_file);
+		cout.rdbuf(output);
+		if(!loaded)
+			return 1;
+		decision_service service(server_g, config.THREADS, config.SEED);
+		if(serve_socket == nullptr)
+		{
+			service.serve_stream(cin, cout);
+			return 0;
+		}
+		return service.serve_socket(serve_socket) ? 0 : 1;
+	}
+
+	if(client_socket != nullptr)
+	{
+		decision_client client;
+		if(!client.connect_to(client_socket))
+			return 1;
+		client.play_game(config.END_TURNS);
+		return 0;
+	}
+
+	if(run_tournament)
+	{
+		for(unsigned int i = 0; i < tournament_files.size(); i++)
+		{
+			if(!test_t.add_file(tournament_files[i]))
+				return 1;
+		}
+		if(test_t.SEED_COUNT < 1 || test_t.entrants.empty())
+		{
+			cout << "A tournament needs at least one seed and one genome" << endl;
+			return 1;
+		}
+		test_t.TURN_LIMIT = config.TEST_TURNS;
+		test_t.BEAM_WIDTH = config.BEAM_WIDTH;
+		test_t.BEAM_DEPTH = config.BEAM_DEPTH;
+		test_t.MCTS_SIMULATIONS = config.MCTS_SIMULATIONS;
+		test_t.MCTS_ROLLOUT_DEPTH = config.MCTS_ROLLOUT_DEPTH;
+		test_t.MCTS_FOOD_SAMPLES = config.MCTS_FOOD_SAMPLES;
+		test_t.SEED = config.SEED;
+		test_t.THREADS = config.THREADS;
+		test_t.run();
+		return 0;
+	}
+
+	if(run_optimizer_benchmark)
+	{
+		if(config.TARGET_FITNESS < 1 || test_o.RUNS < 1)
+		{
+			cout << "An optimizer benchmark needs a positive target and at least one run" << endl;
+			return 1;
+		}
+		test_o.base = config;
+		test_o.run();
+		return 0;
+	}
+
+	if(benchmark_file != nullptr)
+	{
+		genome benchmark_g;
+		if(!benchmark_g.load_from_file(benchmark_file))
+			return 1;
+		search_benchmark benchmark;
+		benchmark.TURN_LIMIT = config.TEST_TURNS;
+		benchmark.SEED = config.SEED;
+		benchmark.run(benchmark_g);
+		return 0;
+	}
+
+	if(batch_check)
+	{
+		//The batch always plays every genome, so screening is turned off in
+		//both runs
+		vector<vector<int>> sorted_fitness[2];
+		for(int batch = 0; batch < 2; batch++)
+		{
+			run_config check_config = config;
+			check_config.BATCH_SIMULATION = batch;
+			check_config.STEADY_STATE = 0;
+			check_config.PROCESSES = 0;
+			check_config.SURROGATE = 0;
+			check_config.DEDUPE_EPSILON = 0;
+			if(!check_config.validate())
+				return 1;
+			evolution check_e(check_config);
+			check_e.verbose = false;
+			check_e.run();
+			check_e.previous_generations.push_back(check_e.generation);
+			for(unsigned int i = 0; i < check_e.previous_generations.size(); i++)
+			{
+				vector<int> fitness;
+				for(unsigned int j = 0; j < check_e.previous_generations[i].size(); j++)
+				{
+					fitness.push_back(check_e.previous_generations[i][j].fitness_value);
+				}
+				sorted_fitness[batch].push_back(fitness);
+			}
+		}
+		if(sorted_fitness[0] == sorted_fitness[1])
+		{
+			cout << "The batch simulation matched the threaded fitness test for "
+				 << sorted_fitness[0].size() << " generations" << endl;
+			return 0;
+		}
+		for(unsigned int i = 0; i < sorted_fitness[0].size() && i < sorted_fitness[1].size(); i++)
+		{
+			if(sorted_fitness[0][i] != sorted_fitness[1][i])
+			{
+				cout << "The batch simulation differs from the threaded fitness test in generation " << i << endl;
+				return 1;
+			}
+		}
+		cout << "The batch simulation ran " << sorted_fitness[1].size() << " generations and the threaded fitness test "
+			 << sorted_fitness[0].size() << endl;
+		return 1;
+	}
+
+	if(play)
+	{
+		const int SEARCH_THREADS = 3;
+		scheduler search_pool(SEARCH_THREADS);
+		genome test_g;
+		if(!test_g.load_from_file(play_file))
+			return 1;
+		test_g.search_pool = &search_pool;
+		test_g.BEAM_WIDTH = config.BEAM_WIDTH;
+		test_g.BEAM_DEPTH = config.BEAM_DEPTH;
+		test_g.MCTS_SIMULATIONS = config.MCTS_SIMULATIONS;
+		test_g.MCTS_ROLLOUT_DEPTH = config.MCTS_ROLLOUT_DEPTH;
+		test_g.MCTS_FOOD_SAMPLES = config.MCTS_FOOD_SAMPLES;
+		test_g.play_game(true, config.END_TURNS, config.DISPLAY_DELAY);
+		test_g.display();
+		return 0;
+	}
 
 	//Spawn the number of generations and test them
-	for(int i = 0; i < test_e.GENERATION_LIMIT; i++)
+	evolution test_e(config);
+	snapshot_ring ring;
+	if(publish_name != nullptr)
 	{
-		test_e.fitness_test(false, TEST_TURNS);
-		test_e.spawn_next_generation();
+		if(!ring.create(publish_name))
+			return 1;
+		test_e.publisher = &ring;
 	}
+	test_e.run();
 
 	//Play a game using the fittest genome from the last generation
 	//And display the results
-	test_e.fitness_test(false, TEST_TURNS);
-	test_e.generation.back().play_game(true, END_TURNS, DISPLAY_DELAY);
+	test_e.generation.back().play_game(true, config.END_TURNS, config.DISPLAY_DELAY);
 	test_e.generation.back().display();
 
 	//Save the characteristics of the fittest genome in a file
 	test_e.generation.back().save_to_file();
 
+	//The generations are kept sorted, so each one's fittest genome is last
+	if(archive_file != nullptr)
+	{
+		vector<genome_record> champions;
+		for(unsigned int i = 0; i < test_e.previous_generations.size(); i++)
+		{
+			champions.push_back(genome_library::to_record(test_e.previous_generations[i].back(), config.TEST_TURNS, config.SEED));
+		}
+		champions.push_back(genome_library::to_record(test_e.generation.back(), config.TEST_TURNS, config.SEED));
+		if(genome_library::append(archive_file, champions))
+			cout << "Archived " << champions.size() << " genomes to " << archive_file << endl;
+	}
+
 	return 0;
 }
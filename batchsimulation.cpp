@@ -0,0 +1,199 @@
+/*
+ * batchsimulation.cpp
+ * This file contains the function implementations for the batch_simulation
+ * class
+ */
+
+#include <algorithm>
+#include "batchsimulation.h"
+using namespace std;
+
+//Starts a game for every seed with the snake along the top row heading right
+void batch_simulation::reset(const vector<unsigned int>& seeds)
+{
+	game_count = seeds.size();
+	active = game_count;
+	MAP_X_LIMIT = state::map_x_setting;
+	MAP_Y_LIMIT = state::map_y_setting;
+	cells = MAP_X_LIMIT * MAP_Y_LIMIT;
+
+	game_index.resize(game_count);
+	head_x.assign(game_count, START_SIZE - 1);
+	head_y.assign(game_count, 0);
+	direction_x.assign(game_count, 1);
+	direction_y.assign(game_count, 0);
+	food_x.assign(game_count, -1);
+	food_y.assign(game_count, -1);
+	score.assign(game_count, 0);
+	turn.assign(game_count, 0);
+	loss.assign(game_count, 0);
+
+	body.assign(game_count * cells, 0);
+	body_start.assign(game_count, 0);
+	body_length.assign(game_count, 0);
+	occupied.assign(game_count, bitboard(MAP_X_LIMIT, MAP_Y_LIMIT));
+	food_source.resize(game_count);
+
+	final_score.assign(game_count, 0);
+	final_turn.assign(game_count, 0);
+
+	next_tile.resize(game_count);
+	ate.resize(game_count);
+
+	for(int lane = 0; lane < game_count; lane++)
+	{
+		game_index[lane] = lane;
+		//The food sequence is seeded the way a new state seeds it after
+		//seed_game_rand, so a lane plays the same food as play_game
+		seed_game_rand(seeds[lane]);
+		food_source[lane] = make_shared<food_sequence>(game_rand());
+		for(int i = 0; i < START_SIZE; i++)
+		{
+			push_head(lane, i);
+		}
+		place_food(lane);
+	}
+}
+
+//Advances all running games by one turn. The first loop has no branches
+//that depend on the body and is vectorized by the compiler across lanes.
+//The second loop updates the bodies, which needs per game memory access.
+//Games that ended are then compacted out of the running lanes.
+void batch_simulation::step(const vector<int>& action_x, const vector<int>& action_y)
+{
+	const int lanes = active;
+	const int width = MAP_X_LIMIT;
+	const int height = MAP_Y_LIMIT;
+
+	for(int lane = 0; lane < lanes; lane++)
+	{
+		int x = head_x[lane] + action_x[lane];
+		int y = head_y[lane] + action_y[lane];
+		direction_x[lane] = action_x[lane];
+		direction_y[lane] = action_y[lane];
+		turn[lane]++;
+		ate[lane] = (x == food_x[lane]) & (y == food_y[lane]);
+		bool outside = (x < 0) | (y < 0) | (x >= width) | (y >= height);
+		next_tile[lane] = outside ? -1 : y * width + x;
+	}
+
+	for(int lane = 0; lane < lanes; lane++)
+	{
+		int tile = next_tile[lane];
+		if(ate[lane])
+		{
+			push_head(lane, tile);
+			score[lane]++;
+			place_food(lane);
+		}
+		//Moving off the map or onto any body segment, including the tail
+		//which has not moved yet, ends the game
+		else if(tile < 0 || occupied[game_index[lane]].test(tile % width, tile / width))
+		{
+			loss[lane] = 1;
+		}
+		else
+		{
+			pop_tail(lane);
+			push_head(lane, tile);
+		}
+	}
+
+	int lane = 0;
+	while(lane < active)
+	{
+		if(loss[lane])
+		{
+			final_score[game_index[lane]] = score[lane];
+			final_turn[game_index[lane]] = turn[lane];
+			active--;
+			swap_lanes(lane, active);
+		}
+		else
+			lane++;
+	}
+}
+
+//Records the results of every game that is still running
+void batch_simulation::finish()
+{
+	for(int lane = 0; lane < active; lane++)
+	{
+		final_score[game_index[lane]] = score[lane];
+		final_turn[game_index[lane]] = turn[lane];
+	}
+	active = 0;
+}
+
+//Copies a lane into a state with the body ordered from tail to head
+state batch_simulation::to_state(int lane)
+{
+	int game = game_index[lane];
+	state s(food_source[game]);
+	s.snake.clear();
+	for(int i = 0; i < body_length[game]; i++)
+	{
+		int tile = body[game * cells + (body_start[game] + i) % cells];
+		s.snake.push_back(coordinate(tile % MAP_X_LIMIT, tile / MAP_X_LIMIT));
+	}
+	s.occupied = occupied[game];
+	s.direction_modifier = coordinate(direction_x[lane], direction_y[lane]);
+	s.food = coordinate(food_x[lane], food_y[lane]);
+	s.score = score[lane];
+	s.loss = loss[lane];
+	return s;
+}
+
+//Places food on the open tile chosen by the game's food sequence, the same
+//rule state::place_food uses, so a lane's searched states agree with it
+void batch_simulation::place_food(int lane)
+{
+	int game = game_index[lane];
+	int open_count = cells - body_length[game];
+	if(open_count <= 0)
+	{
+		food_x[lane] = -1;
+		food_y[lane] = -1;
+		return;
+	}
+	int x;
+	int y;
+	occupied[game].nth_clear(food_source[game]->at(score[lane]) % open_count, x, y);
+	food_x[lane] = x;
+	food_y[lane] = y;
+}
+
+//Adds a new head segment to a lane's snake
+void batch_simulation::push_head(int lane, int tile)
+{
+	int game = game_index[lane];
+	body[game * cells + (body_start[game] + body_length[game]) % cells] = tile;
+	body_length[game]++;
+	occupied[game].set(tile % MAP_X_LIMIT, tile / MAP_X_LIMIT);
+	head_x[lane] = tile % MAP_X_LIMIT;
+	head_y[lane] = tile / MAP_X_LIMIT;
+}
+
+//Removes the tail segment of a lane's snake
+void batch_simulation::pop_tail(int lane)
+{
+	int game = game_index[lane];
+	int tail = body[game * cells + body_start[game]];
+	occupied[game].reset(tail % MAP_X_LIMIT, tail / MAP_X_LIMIT);
+	body_start[game] = (body_start[game] + 1) % cells;
+	body_length[game]--;
+}
+
+void batch_simulation::swap_lanes(int a, int b)
+{
+	swap(game_index[a], game_index[b]);
+	swap(head_x[a], head_x[b]);
+	swap(head_y[a], head_y[b]);
+	swap(direction_x[a], direction_x[b]);
+	swap(direction_y[a], direction_y[b]);
+	swap(food_x[a], food_x[b]);
+	swap(food_y[a], food_y[b]);
+	swap(score[a], score[b]);
+	swap(turn[a], turn[b]);
+	swap(loss[a], loss[b]);
+}
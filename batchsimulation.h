@@ -0,0 +1,86 @@
+/*
+ * batchsimulation.h
+ * This file contains the header information for the batch_simulation class
+ * which advances many independent snake games in lockstep
+ */
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "bitboard.h"
+#include "game.h"
+using namespace std;
+
+#ifndef BATCHSIMULATION_H_
+#define BATCHSIMULATION_H_
+
+//A batch simulation stores many games as arrays instead of one object per
+//game. Values that every step touches are kept per lane, and the lanes are
+//compacted after each step so lanes [0, active) are the games still running.
+//The snake bodies and occupancy grids are large, so they stay in per game
+//slabs that lanes refer to through game_index.
+class batch_simulation
+{
+	public:
+		//Size of the snake to start each game and the map limits, taken from
+		//the state settings when the batch is reset
+		int START_SIZE = 5;
+		int MAP_X_LIMIT = state::map_x_setting;
+		int MAP_Y_LIMIT = state::map_y_setting;
+		int cells = 0;
+
+		//The number of games in the batch and the number still running
+		int game_count = 0;
+		int active = 0;
+
+		//Per lane values
+		vector<int> game_index;
+		vector<int> head_x;
+		vector<int> head_y;
+		vector<int> direction_x;
+		vector<int> direction_y;
+		vector<int> food_x;
+		vector<int> food_y;
+		vector<int> score;
+		vector<int> turn;
+		vector<uint8_t> loss;
+
+		//Per game slabs. Each body is a ring of tile indices from tail to head.
+		vector<int> body;
+		vector<int> body_start;
+		vector<int> body_length;
+		vector<bitboard> occupied;
+		//Each game's food sequence, shared with the states built for its search
+		vector<shared_ptr<food_sequence>> food_source;
+
+		//Results by game, filled in as games end or when the batch is finished
+		vector<int> final_score;
+		vector<int> final_turn;
+
+		//Starts one game per seed from the standard starting position. The
+		//seed is the one play_game's game is started with, and reseeds
+		//game_rand of the calling thread.
+		void reset(const vector<unsigned int>& seeds);
+
+		//Advances every running game by one turn. The actions are unit
+		//vectors indexed by lane.
+		void step(const vector<int>& action_x, const vector<int>& action_y);
+
+		//Records the results of the games still running, used at a turn limit
+		void finish();
+
+		//Builds a state object for a lane so a genome can choose its action
+		state to_state(int lane);
+
+	private:
+		//Scratch values computed by the vectorized part of a step
+		vector<int> next_tile;
+		vector<uint8_t> ate;
+
+		void place_food(int lane);
+		void push_head(int lane, int tile);
+		void pop_tail(int lane);
+		void swap_lanes(int a, int b);
+};
+
+#endif /* BATCHSIMULATION_H_ */
@@ -0,0 +1,186 @@
+/*
+ * bitboard.cpp
+ * This file contains the function implementations for the bitboard class
+ */
+
+#include "bitboard.h"
+using namespace std;
+
+bitboard::bitboard(int new_width, int new_height)
+{
+	width = new_width;
+	height = new_height;
+	//The extra bit keeps a gap between rows for the shift based fill
+	words_per_row = width / 64 + 1;
+	words.assign(words_per_row * height, 0);
+}
+
+void bitboard::set(int x, int y)
+{
+	words[y * words_per_row + x / 64] |= uint64_t(1) << (x % 64);
+}
+
+void bitboard::reset(int x, int y)
+{
+	words[y * words_per_row + x / 64] &= ~(uint64_t(1) << (x % 64));
+}
+
+bool bitboard::test(int x, int y) const
+{
+	return (words[y * words_per_row + x / 64] >> (x % 64)) & 1;
+}
+
+int bitboard::count() const
+{
+	int total = 0;
+	for(unsigned int i = 0; i < words.size(); i++)
+	{
+		total += __builtin_popcountll(words[i]);
+	}
+	return total;
+}
+
+//Sets the tiles inside the map and leaves the gap bits of each row clear
+void bitboard::fill()
+{
+	for(int y = 0; y < height; y++)
+	{
+		for(int i = 0; i < words_per_row; i++)
+		{
+			words[y * words_per_row + i] = row_mask(i);
+		}
+	}
+}
+
+//Counts the clear tiles a word at a time and only looks at single bits
+//inside the word that holds the wanted tile
+bool bitboard::nth_clear(int n, int& x, int& y) const
+{
+	for(int row = 0; row < height; row++)
+	{
+		for(int i = 0; i < words_per_row; i++)
+		{
+			uint64_t clear = ~words[row * words_per_row + i] & row_mask(i);
+			int clear_count = __builtin_popcountll(clear);
+			if(n >= clear_count)
+			{
+				n -= clear_count;
+				continue;
+			}
+			//Drop the lowest clear bits until the wanted one is the lowest
+			for(int j = 0; j < n; j++)
+			{
+				clear &= clear - 1;
+			}
+			x = i * 64 + __builtin_ctzll(clear);
+			y = row;
+			return true;
+		}
+	}
+	return false;
+}
+
+uint64_t bitboard::row_mask(int word_in_row) const
+{
+	int bits = width - word_in_row * 64;
+	if(bits >= 64)
+		return ~uint64_t(0);
+	if(bits > 0)
+		return (uint64_t(1) << bits) - 1;
+	return 0;
+}
+
+//Spreads the set bits of a word towards higher bits through the open bits,
+//doubling the distance covered at each step
+static uint64_t fill_up(uint64_t reached, uint64_t open)
+{
+	reached |= open & (reached << 1);
+	open &= open << 1;
+	reached |= open & (reached << 2);
+	open &= open << 2;
+	reached |= open & (reached << 4);
+	open &= open << 4;
+	reached |= open & (reached << 8);
+	open &= open << 8;
+	reached |= open & (reached << 16);
+	open &= open << 16;
+	reached |= open & (reached << 32);
+	return reached;
+}
+
+//Spreads the set bits of a word towards lower bits through the open bits
+static uint64_t fill_down(uint64_t reached, uint64_t open)
+{
+	reached |= open & (reached >> 1);
+	open &= open >> 1;
+	reached |= open & (reached >> 2);
+	open &= open >> 2;
+	reached |= open & (reached >> 4);
+	open &= open >> 4;
+	reached |= open & (reached >> 8);
+	open &= open >> 8;
+	reached |= open & (reached >> 16);
+	open &= open >> 16;
+	reached |= open & (reached >> 32);
+	return reached;
+}
+
+//Fills every row of the reached tiles along its runs of open tiles. Each row
+//is swept right then left, carrying the edge bit into the next word. The gap
+//bit at the end of a row is never open, so nothing carries between rows.
+static void fill_rows(vector<uint64_t>& reached, const vector<uint64_t>& open, int words_per_row)
+{
+	for(unsigned int row = 0; row < reached.size(); row += words_per_row)
+	{
+		uint64_t carry = 0;
+		for(int i = 0; i < words_per_row; i++)
+		{
+			uint64_t word = reached[row + i] | (carry & open[row + i]);
+			word = fill_up(word, open[row + i]);
+			carry = word >> 63;
+			reached[row + i] = word;
+		}
+		carry = 0;
+		for(int i = words_per_row - 1; i >= 0; i--)
+		{
+			uint64_t word = reached[row + i] | ((carry << 63) & open[row + i]);
+			word = fill_down(word, open[row + i]);
+			carry = word & 1;
+			reached[row + i] = word;
+		}
+	}
+}
+
+//Alternates filling whole runs of open tiles along the rows with sweeps that
+//spread the reached tiles into the rows below and above, until a sweep adds
+//no new tiles. The number of rounds depends on how often a path turns rather
+//than on its length, so open maps fill in a few rounds.
+bitboard bitboard::flood_fill(int start_x, int start_y, const bitboard& open) const
+{
+	bitboard reached(width, height);
+	reached.set(start_x, start_y);
+	vector<uint64_t>& tiles = reached.words;
+	const int total_words = tiles.size();
+
+	bool changed = true;
+	while(changed)
+	{
+		fill_rows(tiles, open.words, words_per_row);
+		changed = false;
+		//Downward sweep, where each row sees the already updated row above
+		for(int i = words_per_row; i < total_words; i++)
+		{
+			uint64_t grown = tiles[i] | (tiles[i - words_per_row] & open.words[i]);
+			changed |= grown != tiles[i];
+			tiles[i] = grown;
+		}
+		//Upward sweep
+		for(int i = total_words - words_per_row - 1; i >= 0; i--)
+		{
+			uint64_t grown = tiles[i] | (tiles[i + words_per_row] & open.words[i]);
+			changed |= grown != tiles[i];
+			tiles[i] = grown;
+		}
+	}
+	return reached;
+}
@@ -0,0 +1,52 @@
+/*
+ * bitboard.h
+ * This file contains the header information for the bitboard class which
+ * stores one bit per map tile
+ */
+
+#include <cstdint>
+#include <vector>
+using namespace std;
+
+#ifndef BITBOARD_H_
+#define BITBOARD_H_
+
+//A bitboard stores one bit for every tile of the map. Each row starts on a
+//new 64 bit word and keeps at least one unused bit at its end, so shifting
+//the whole board by one bit moves tiles left or right without carrying them
+//into a neighbouring row, and shifting by a row's words moves tiles up or down.
+class bitboard
+{
+	public:
+		int width;
+		int height;
+		int words_per_row;
+		vector<uint64_t> words;
+
+		bitboard(int new_width = 0, int new_height = 0);
+
+		//Functions to read and write single tiles
+		void set(int x, int y);
+		void reset(int x, int y);
+		bool test(int x, int y) const;
+
+		//Returns the number of tiles that are set
+		int count() const;
+
+		//Sets every tile of the map
+		void fill();
+
+		//Finds the nth tile of the map that is not set, counting from zero
+		//in row order. Returns false if there are not that many clear tiles.
+		bool nth_clear(int n, int& x, int& y) const;
+
+		//Returns the tiles reachable from the start tile through open tiles.
+		//The start tile is always included.
+		bitboard flood_fill(int start_x, int start_y, const bitboard& open) const;
+
+	private:
+		//Returns the bits of a row's word that lie inside the map
+		uint64_t row_mask(int word_in_row) const;
+};
+
+#endif /* BITBOARD_H_ */
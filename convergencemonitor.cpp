@@ -0,0 +1,42 @@
+/*
+ * convergencemonitor.cpp
+ * This file contains the function implementations for the convergence
+ * monitor
+ */
+
+#include "convergencemonitor.h"
+using namespace std;
+
+convergence_action convergence_monitor::update(int best, int median, double gene_diversity)
+{
+	bool first = best_fitness.empty();
+	best_fitness.push_back(best);
+	median_fitness.push_back(median);
+	diversity.push_back(gene_diversity);
+	if(PATIENCE <= 0)
+		return CONVERGENCE_CONTINUE;
+
+	if(first || best > highest_best || median > highest_median)
+	{
+		stalled_generations = 0;
+		if(first || best > highest_best)
+			highest_best = best;
+		if(first || median > highest_median)
+			highest_median = median;
+	}
+	else
+		stalled_generations++;
+
+	bool collapsed = DIVERSITY_FLOOR > 0 && gene_diversity < DIVERSITY_FLOOR;
+	if(stalled_generations < PATIENCE && !collapsed)
+		return CONVERGENCE_CONTINUE;
+
+	//A restart gets a fresh count so the new genomes have time to compete
+	stalled_generations = 0;
+	if(restarts < RESTART_LIMIT && RESTART_FRACTION > 0)
+	{
+		restarts++;
+		return CONVERGENCE_RESTART;
+	}
+	return CONVERGENCE_STOP;
+}
@@ -0,0 +1,52 @@
+/*
+ * convergencemonitor.h
+ * This file contains the header information for the convergence monitor
+ * which decides when an evolution has stopped making progress
+ */
+
+#include <vector>
+using namespace std;
+
+#ifndef CONVERGENCEMONITOR_H_
+#define CONVERGENCEMONITOR_H_
+
+//What an evolution should do after a generation
+enum convergence_action {CONVERGENCE_CONTINUE, CONVERGENCE_RESTART, CONVERGENCE_STOP};
+
+//Tracks the best and median fitness and the gene diversity of each
+//generation. Progress has stalled when neither the best nor the median
+//fitness has beaten its highest value for PATIENCE generations, or when the
+//diversity falls below DIVERSITY_FLOOR. A stall re-randomizes part of the
+//population until RESTART_LIMIT restarts have been used, then stops the run.
+class convergence_monitor
+{
+	public:
+		//The number of generations without progress that count as a stall,
+		//where zero never stalls
+		int PATIENCE = 0;
+		//The share of the next generation replaced by random genomes on a
+		//stall, and the number of times that is done before stopping
+		float RESTART_FRACTION = 0.5;
+		int RESTART_LIMIT = 2;
+		//The mean standard deviation of the genes below which the population
+		//counts as collapsed, where zero ignores diversity
+		float DIVERSITY_FLOOR = 0;
+
+		//The history of every generation seen
+		vector<int> best_fitness;
+		vector<int> median_fitness;
+		vector<double> diversity;
+
+		int restarts = 0;
+		int generations_saved = 0;
+
+		//Records a generation and returns what to do next
+		convergence_action update(int best, int median, double gene_diversity);
+
+	private:
+		int highest_best = 0;
+		int highest_median = 0;
+		int stalled_generations = 0;
+};
+
+#endif /* CONVERGENCEMONITOR_H_ */
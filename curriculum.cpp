@@ -0,0 +1,38 @@
+/*
+ * curriculum.cpp
+ * This file contains the function implementations for the turn curriculum
+ */
+
+#include <algorithm>
+#include "curriculum.h"
+#include "evolutionaryframework.h"
+using namespace std;
+
+//A game lasting the whole limit is assumed to survive to FULL_TURNS
+int turn_curriculum::projected_fitness(int score, int turns, int limit)
+{
+	if(turns >= limit)
+		turns = max(turns, FULL_TURNS);
+	return score * genome::SCORE_WEIGHT + turns * genome::TURN_WEIGHT;
+}
+
+bool turn_curriculum::update(const vector<int>& game_turns)
+{
+	long long turns = 0;
+	for(unsigned int i = 0; i < game_turns.size(); i++)
+	{
+		turns += game_turns[i];
+	}
+	limits.push_back(turn_limit);
+	turns_simulated.push_back(turns);
+	turns_total += turns;
+	if(turn_limit >= FULL_TURNS || game_turns.empty())
+		return false;
+
+	vector<int> sorted = game_turns;
+	nth_element(sorted.begin(), sorted.begin() + sorted.size() / 2, sorted.end());
+	if(sorted[sorted.size() / 2] < RAISE_THRESHOLD * turn_limit)
+		return false;
+	turn_limit = min(2 * turn_limit, FULL_TURNS);
+	return true;
+}
@@ -0,0 +1,51 @@
+/*
+ * curriculum.h
+ * This file contains the header information for the turn curriculum which
+ * raises the turn limit of fitness games as a population learns to survive
+ */
+
+#include <vector>
+using namespace std;
+
+#ifndef CURRICULUM_H_
+#define CURRICULUM_H_
+
+//Plays the early generations of a run with short fitness games. A
+//generation whose median game lasts RAISE_THRESHOLD of the turn limit has
+//the limit doubled for the next one, until it reaches FULL_TURNS.
+//Games are reproducible from their seeds, so a game that ends before the
+//limit ends the same way with any longer limit and keeps its fitness. Only
+//a game cut off by a short limit is projected, scored as if it survived to
+//FULL_TURNS with the food it had eaten, which keeps fitness values from
+//every stage in the same units. Its score is not scaled up, since one early
+//piece of food would then outweigh everything else. The projection is an
+//estimate, so the last generation of a run that reaches its generation
+//limit is played with the full limit, and a target fitness only ends a run
+//at the full limit.
+class turn_curriculum
+{
+	public:
+		//The turn limit of the first generation, where zero plays every
+		//generation with FULL_TURNS
+		int START_TURNS = 0;
+		int FULL_TURNS = 500;
+		float RAISE_THRESHOLD = 0.9;
+
+		//The limit the next generation plays with
+		int turn_limit = 500;
+
+		//The limit and the number of turns played of every generation seen
+		vector<int> limits;
+		vector<long long> turns_simulated;
+		long long turns_total = 0;
+
+		//Returns the fitness of a game played with limit in the units of a
+		//game with FULL_TURNS
+		int projected_fitness(int score, int turns, int limit);
+
+		//Records the length of every game of a generation and returns true if
+		//the limit was raised for the next generation
+		bool update(const vector<int>& game_turns);
+};
+
+#endif /* CURRICULUM_H_ */
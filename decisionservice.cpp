@@ -0,0 +1,415 @@
+/*
+ * decisionservice.cpp
+ * This file contains the function implementations for the decision service
+ * and its client
+ */
+
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <memory>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "decisionservice.h"
+using namespace std;
+
+//Returns the value below which the given percent of the values fall, using
+//the nearest rank
+static double percentile(vector<double> values, int percent)
+{
+	if(values.empty())
+		return 0;
+	sort(values.begin(), values.end());
+	int rank = (percent * (int)values.size() + 99) / 100;
+	return values[max(rank - 1, 0)];
+}
+
+//Reads up to the next newline from a socket, keeping any following bytes in
+//the buffer for the next call. Returns false once the connection closes.
+static bool read_line(int descriptor, string& buffer, string& line)
+{
+	size_t newline;
+	while((newline = buffer.find('\n')) == string::npos)
+	{
+		char bytes[4096];
+		ssize_t count = recv(descriptor, bytes, sizeof(bytes), 0);
+		if(count <= 0)
+			return false;
+		buffer.append(bytes, count);
+	}
+	line = buffer.substr(0, newline);
+	buffer.erase(0, newline + 1);
+	if(!line.empty() && line.back() == '\r')
+		line.pop_back();
+	return true;
+}
+
+static bool write_all(int descriptor, const string& text)
+{
+	size_t sent = 0;
+	while(sent < text.size())
+	{
+		ssize_t count = send(descriptor, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+		if(count <= 0)
+			return false;
+		sent += count;
+	}
+	return true;
+}
+
+//Creates a Unix domain socket address, or returns false if the path is too long
+static bool socket_address(const char* path, sockaddr_un& address)
+{
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if(strlen(path) >= sizeof(address.sun_path))
+		return false;
+	strcpy(address.sun_path, path);
+	return true;
+}
+
+string encode_state(long long id, state& s)
+{
+	ostringstream line;
+	line << id << " " << s.score << " " << s.direction_modifier.x << " " << s.direction_modifier.y
+		 << " " << s.food.x << " " << s.food.y << " " << s.snake.size();
+	for(int i = s.snake.size() - 1; i >= 0; i--)
+	{
+		line << " " << s.snake[i].x << " " << s.snake[i].y;
+	}
+	return line.str();
+}
+
+//The snake is stored from the tail to the head, the reverse of the request
+bool decode_state(const string& line, long long& id, state& s, string& problem)
+{
+	istringstream input(line);
+	int length;
+	if(!(input >> id))
+	{
+		id = -1;
+		problem = "missing id";
+		return false;
+	}
+	if(!(input >> s.score >> s.direction_modifier.x >> s.direction_modifier.y
+			   >> s.food.x >> s.food.y >> length))
+	{
+		problem = "incomplete request";
+		return false;
+	}
+	if(abs(s.direction_modifier.x) + abs(s.direction_modifier.y) != 1)
+	{
+		problem = "direction is not a unit vector";
+		return false;
+	}
+	if(length < 1 || length > s.MAP_X_LIMIT * s.MAP_Y_LIMIT)
+	{
+		problem = "invalid snake length";
+		return false;
+	}
+	//The score indexes the food sequence when a searched move eats
+	if(s.score < 0 || s.score > s.MAP_X_LIMIT * s.MAP_Y_LIMIT)
+	{
+		problem = "invalid score";
+		return false;
+	}
+	bool no_food = s.food.x == -1 && s.food.y == -1;
+	if(!no_food && (s.food.x < 0 || s.food.y < 0 || s.food.x >= s.MAP_X_LIMIT || s.food.y >= s.MAP_Y_LIMIT))
+	{
+		problem = "food is outside the map";
+		return false;
+	}
+
+	s.snake.assign(length, coordinate());
+	s.occupied = bitboard(s.MAP_X_LIMIT, s.MAP_Y_LIMIT);
+	for(int i = length - 1; i >= 0; i--)
+	{
+		coordinate& segment = s.snake[i];
+		if(!(input >> segment.x >> segment.y))
+		{
+			problem = "incomplete snake";
+			return false;
+		}
+		if(segment.x < 0 || segment.y < 0 || segment.x >= s.MAP_X_LIMIT || segment.y >= s.MAP_Y_LIMIT)
+		{
+			problem = "snake is outside the map";
+			return false;
+		}
+		if(s.occupied.test(segment.x, segment.y))
+		{
+			problem = "snake overlaps itself";
+			return false;
+		}
+		s.occupied.set(segment.x, segment.y);
+	}
+	if(!no_food && s.occupied.test(s.food.x, s.food.y))
+	{
+		problem = "food is on the snake";
+		return false;
+	}
+	string extra;
+	if(input >> extra)
+	{
+		problem = "unexpected text after the snake";
+		return false;
+	}
+	s.loss = false;
+	s.turn = 0;
+	return true;
+}
+
+decision_service::decision_service(genome new_player, int thread_count, unsigned int new_food_seed)
+	: player(new_player), food_seed(new_food_seed), pool(thread_count)
+{
+	dispatcher = thread(&decision_service::dispatch_loop, this);
+}
+
+decision_service::~decision_service()
+{
+	stop();
+}
+
+//Lets the dispatcher finish the queued requests and joins it
+void decision_service::stop()
+{
+	{
+		lock_guard<mutex> guard(queue_lock);
+		stopping = true;
+	}
+	queue_ready.notify_all();
+	if(dispatcher.joinable())
+		dispatcher.join();
+}
+
+void decision_service::submit(const string& line, function<void(const string&)> reply)
+{
+	if(line.empty())
+		return;
+	if(line == "stats")
+	{
+		reply(latency_summary());
+		return;
+	}
+
+	decision_request request;
+	request.line = line;
+	request.received = chrono::steady_clock::now();
+	request.reply = reply;
+	{
+		lock_guard<mutex> guard(queue_lock);
+		requests.push_back(request);
+	}
+	queue_ready.notify_one();
+}
+
+//Takes every queued request as one batch and decides them on the pool. The
+//requests that arrive meanwhile form the next batch.
+void decision_service::dispatch_loop()
+{
+	while(true)
+	{
+		deque<decision_request> batch;
+		{
+			unique_lock<mutex> guard(queue_lock);
+			queue_ready.wait(guard, [this]{return stopping || !requests.empty();});
+			if(requests.empty())
+				return;
+			batch.swap(requests);
+		}
+
+		task_group decisions;
+		for(unsigned int i = 0; i < batch.size(); i++)
+		{
+			decision_request* request = &batch[i];
+			pool.submit(decisions, [this, request]()
+			{
+				request->reply(decide(request->line));
+				record_latency(chrono::duration<double, micro>(chrono::steady_clock::now() - request->received).count());
+			});
+		}
+		pool.wait(decisions);
+	}
+}
+
+//Every request searches with the same food sequence and breaks ties with a
+//generator seeded from its id, so a request always gets the same answer
+string decision_service::decide(const string& line)
+{
+	state s(make_shared<food_sequence>(food_seed));
+	long long id;
+	string problem;
+	if(!decode_state(line, id, s, problem))
+		return to_string(id) + " error " + problem;
+
+	seed_game_rand(food_seed + static_cast<unsigned int>(id) * 104729u);
+	genome searcher = player;
+	coordinate action = searcher.optimize_action(s);
+	return to_string(id) + " " + to_string(action.x) + " " + to_string(action.y);
+}
+
+void decision_service::record_latency(double microseconds)
+{
+	bool report;
+	{
+		lock_guard<mutex> guard(latency_lock);
+		if((int)latencies.size() < LATENCY_WINDOW)
+			latencies.push_back(microseconds);
+		else
+			latencies[decisions % LATENCY_WINDOW] = microseconds;
+		decisions++;
+		report = decisions % REPORT_INTERVAL == 0;
+	}
+	if(report)
+		cerr << latency_summary() << endl;
+}
+
+string decision_service::latency_summary()
+{
+	vector<double> recent;
+	long long count;
+	{
+		lock_guard<mutex> guard(latency_lock);
+		recent = latencies;
+		count = decisions;
+	}
+	ostringstream summary;
+	summary << "stats " << count << " " << percentile(recent, 50) << " " << percentile(recent, 99);
+	return summary.str();
+}
+
+void decision_service::serve_stream(istream& input, ostream& output)
+{
+	mutex output_lock;
+	auto reply = [&](const string& line)
+	{
+		lock_guard<mutex> guard(output_lock);
+		output << line << endl;
+	};
+
+	string line;
+	while(getline(input, line))
+	{
+		if(!line.empty() && line.back() == '\r')
+			line.pop_back();
+		if(line == "quit")
+			break;
+		submit(line, reply);
+	}
+	stop();
+	cerr << latency_summary() << endl;
+}
+
+//A connection stays open until its reader has finished and every reply to
+//it has been written
+class service_connection
+{
+	public:
+		int descriptor;
+		mutex write_lock;
+
+		service_connection(int new_descriptor) {descriptor = new_descriptor;}
+		~service_connection() {close(descriptor);}
+};
+
+bool decision_service::serve_socket(const char* path)
+{
+	sockaddr_un address;
+	int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(listener < 0 || !socket_address(path, address))
+	{
+		cout << "Failed to create decision socket " << path << endl;
+		return false;
+	}
+	unlink(path);
+	if(bind(listener, (sockaddr*)&address, sizeof(address)) != 0 || listen(listener, 64) != 0)
+	{
+		close(listener);
+		cout << "Failed to listen on decision socket " << path << endl;
+		return false;
+	}
+	cout << "Serving decisions on " << path << endl;
+
+	while(true)
+	{
+		int descriptor = accept(listener, nullptr, nullptr);
+		if(descriptor < 0)
+			continue;
+		shared_ptr<service_connection> connection = make_shared<service_connection>(descriptor);
+		thread([this, connection]()
+		{
+			auto reply = [connection](const string& line)
+			{
+				lock_guard<mutex> guard(connection->write_lock);
+				write_all(connection->descriptor, line + "\n");
+			};
+			string buffer;
+			string line;
+			while(read_line(connection->descriptor, buffer, line) && line != "quit")
+			{
+				submit(line, reply);
+			}
+		}).detach();
+	}
+}
+
+decision_client::~decision_client()
+{
+	if(descriptor >= 0)
+	{
+		write_all(descriptor, "quit\n");
+		close(descriptor);
+	}
+}
+
+bool decision_client::connect_to(const char* path)
+{
+	sockaddr_un address;
+	descriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(descriptor < 0 || !socket_address(path, address) || connect(descriptor, (sockaddr*)&address, sizeof(address)) != 0)
+	{
+		cout << "Failed to connect to decision socket " << path << endl;
+		return false;
+	}
+	return true;
+}
+
+bool decision_client::request(const string& line, string& reply)
+{
+	return write_all(descriptor, line + "\n") && read_line(descriptor, buffer, reply);
+}
+
+bool decision_client::decide(state& s, coordinate& action)
+{
+	string reply;
+	if(!request(encode_state(next_id++, s), reply))
+		return false;
+	long long id;
+	istringstream input(reply);
+	return (bool)(input >> id >> action.x >> action.y);
+}
+
+void decision_client::play_game(const int turn_limit)
+{
+	game test_game;
+	vector<double> latencies;
+	for(int i = 0; i < turn_limit && !test_game.current_state.loss; i++)
+	{
+		coordinate action;
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		if(!decide(test_game.current_state, action))
+		{
+			cout << "Lost the connection to the decision service" << endl;
+			return;
+		}
+		latencies.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - start).count());
+		test_game.update(action);
+	}
+
+	string service_stats;
+	request("stats", service_stats);
+	cout << "Final Score: " << test_game.current_state.score << " Turns: " << test_game.turn << endl;
+	cout << "Round Trip Latency p50: " << percentile(latencies, 50) << "us p99: " << percentile(latencies, 99) << "us" << endl;
+	cout << "Service " << service_stats << endl;
+}
@@ -0,0 +1,123 @@
+/*
+ * decisionservice.h
+ * This file contains the header information for the decision service, which
+ * lets other programs ask a loaded genome for actions, and its client
+ */
+
+#include <iostream>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "evolutionaryframework.h"
+#include "scheduler.h"
+using namespace std;
+
+#ifndef DECISIONSERVICE_H_
+#define DECISIONSERVICE_H_
+
+//Requests and replies are single lines of text. A request is
+//    id score direction_x direction_y food_x food_y length x1 y1 ... xn yn
+//with the body listed from the head to the tail, and its reply is
+//    id action_x action_y
+//where the action is a unit vector. Malformed requests are answered with
+//    id error description
+//The line "stats" is answered at once with the decision count and the p50
+//and p99 latencies in microseconds, and "quit" closes the connection.
+//The map size is the one the service was started with.
+
+//Writes a state as a request line
+string encode_state(long long id, state& s);
+//Reads a request line into a state. Returns false and describes the
+//problem if the line is not a valid state.
+bool decode_state(const string& line, long long& id, state& s, string& problem);
+
+//A request line waiting to be answered
+class decision_request
+{
+	public:
+		string line;
+		chrono::steady_clock::time_point received;
+		function<void(const string&)> reply;
+};
+
+//The service loads one genome and answers requests from any number of
+//connections. Requests that arrive while a batch is being decided are
+//collected into the next batch, which is spread over the thread pool.
+class decision_service
+{
+	public:
+		//The number of decisions between latency reports
+		static const int REPORT_INTERVAL = 1000;
+		//The number of recent decisions the latency percentiles cover
+		static const int LATENCY_WINDOW = 10000;
+
+		decision_service(genome new_player, int thread_count = 0, unsigned int food_seed = 5);
+		~decision_service();
+
+		//Answers the requests read from the input on the output until the
+		//input ends. Latency reports go to the standard error so they never
+		//mix with replies on the standard output.
+		void serve_stream(istream& input, ostream& output);
+		//Accepts connections to a Unix domain socket and answers each
+		//connection's requests until the process is stopped. Returns false
+		//if the socket cannot be created.
+		bool serve_socket(const char* path);
+
+		//Decides the action for one request line and returns the reply line
+		string decide(const string& line);
+
+		//Returns "stats count p50 p99" for the recent decisions
+		string latency_summary();
+
+	private:
+		genome player;
+		unsigned int food_seed;
+		scheduler pool;
+
+		mutex queue_lock;
+		condition_variable queue_ready;
+		deque<decision_request> requests;
+		bool stopping = false;
+		thread dispatcher;
+
+		mutex latency_lock;
+		vector<double> latencies;
+		long long decisions = 0;
+
+		//Queues a request line, or answers it at once if it is not a state
+		void submit(const string& line, function<void(const string&)> reply);
+		void dispatch_loop();
+		void record_latency(double microseconds);
+		void stop();
+};
+
+//A client of a decision service listening on a Unix domain socket
+class decision_client
+{
+	public:
+		~decision_client();
+
+		//Returns false if the service cannot be reached
+		bool connect_to(const char* path);
+		//Sends a request line and waits for its reply line. Returns false if
+		//the connection is lost.
+		bool request(const string& line, string& reply);
+		//Asks for the action of a state
+		bool decide(state& s, coordinate& action);
+
+		//Plays a game in which every action is chosen by the service, then
+		//prints the result and the round trip latency percentiles
+		void play_game(const int turn_limit);
+
+	private:
+		int descriptor = -1;
+		long long next_id = 0;
+		string buffer;
+};
+
+#endif /* DECISIONSERVICE_H_ */
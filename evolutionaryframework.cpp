@@ -10,45 +10,94 @@
 #include <cmath>
 #include <chrono>
 #include <thread>
+#include <climits>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
 #include "game.h"
+#include "batchsimulation.h"
 #include "evolutionaryframework.h"
+#include "mctsplanner.h"
+#include "optimizer.h"
+#include "perfcounters.h"
+#include "processpool.h"
+#include "snapshotring.h"
+#include "surrogatemodel.h"
 using namespace std;
 
 //Assigns random values between -0.5 and 0.5 for all genes in the genome
-void genome::randomize()
+void genome::randomize(minstd_rand& engine)
 {
-	gene_turn_count = static_cast<float>(rand())/static_cast<float>(RAND_MAX);
+	gene_turn_count = static_cast<float>(engine())/static_cast<float>(engine.max());
 	gene_turn_count = gene_turn_count - 0.5;
 
-	gene_score = static_cast<float>(rand())/static_cast<float>(RAND_MAX);
+	gene_score = static_cast<float>(engine())/static_cast<float>(engine.max());
 	gene_score = gene_score - 0.5;
 
-	gene_distance_to_food = static_cast<float>(rand())/static_cast<float>(RAND_MAX);
+	gene_distance_to_food = static_cast<float>(engine())/static_cast<float>(engine.max());
 	gene_distance_to_food = gene_distance_to_food - 0.5;
 
-	gene_distance_to_top_edge = static_cast<float>(rand())/static_cast<float>(RAND_MAX);
+	gene_distance_to_top_edge = static_cast<float>(engine())/static_cast<float>(engine.max());
 	gene_distance_to_top_edge = gene_distance_to_top_edge - 0.5;
 
-	gene_distance_to_bottom_edge = static_cast<float>(rand())/static_cast<float>(RAND_MAX);
+	gene_distance_to_bottom_edge = static_cast<float>(engine())/static_cast<float>(engine.max());
 	gene_distance_to_bottom_edge = gene_distance_to_bottom_edge - 0.5;
 
-	gene_distance_to_left_edge = static_cast<float>(rand())/static_cast<float>(RAND_MAX);
+	gene_distance_to_left_edge = static_cast<float>(engine())/static_cast<float>(engine.max());
 	gene_distance_to_left_edge = gene_distance_to_left_edge - 0.5;
 
-	gene_distance_to_right_edge = static_cast<float>(rand())/static_cast<float>(RAND_MAX);
+	gene_distance_to_right_edge = static_cast<float>(engine())/static_cast<float>(engine.max());
 	gene_distance_to_right_edge = gene_distance_to_right_edge - 0.5;
 
-	gene_distance_to_up_body = static_cast<float>(rand())/static_cast<float>(RAND_MAX);
+	gene_distance_to_up_body = static_cast<float>(engine())/static_cast<float>(engine.max());
 	gene_distance_to_up_body = gene_distance_to_up_body - 0.5;
 
-	gene_distance_to_down_body = static_cast<float>(rand())/static_cast<float>(RAND_MAX);
+	gene_distance_to_down_body = static_cast<float>(engine())/static_cast<float>(engine.max());
 	gene_distance_to_down_body = gene_distance_to_down_body - 0.5;
 
-	gene_distance_to_left_body = static_cast<float>(rand())/static_cast<float>(RAND_MAX);
+	gene_distance_to_left_body = static_cast<float>(engine())/static_cast<float>(engine.max());
 	gene_distance_to_left_body = gene_distance_to_left_body - 0.5;
 
-	gene_distance_to_right_body = static_cast<float>(rand())/static_cast<float>(RAND_MAX);
+	gene_distance_to_right_body = static_cast<float>(engine())/static_cast<float>(engine.max());
 	gene_distance_to_right_body = gene_distance_to_right_body - 0.5;
+
+	gene_reachable_area = static_cast<float>(engine())/static_cast<float>(engine.max());
+	gene_reachable_area = gene_reachable_area - 0.5;
+
+	gene_tail_reachable = static_cast<float>(engine())/static_cast<float>(engine.max());
+	gene_tail_reachable = gene_tail_reachable - 0.5;
+}
+
+//Returns the gene values in declaration order
+vector<float> genome::genes()
+{
+	return {gene_turn_count, gene_score, gene_distance_to_food,
+			gene_distance_to_top_edge, gene_distance_to_bottom_edge,
+			gene_distance_to_left_edge, gene_distance_to_right_edge,
+			gene_distance_to_up_body, gene_distance_to_down_body,
+			gene_distance_to_left_body, gene_distance_to_right_body,
+			gene_reachable_area, gene_tail_reachable};
+}
+
+//Sets the gene values from a vector in declaration order. Missing values
+//leave the remaining genes at zero.
+void genome::set_genes(const vector<float>& values)
+{
+	vector<float> padded = values;
+	padded.resize(GENE_COUNT, 0);
+	gene_turn_count = padded[0];
+	gene_score = padded[1];
+	gene_distance_to_food = padded[2];
+	gene_distance_to_top_edge = padded[3];
+	gene_distance_to_bottom_edge = padded[4];
+	gene_distance_to_left_edge = padded[5];
+	gene_distance_to_right_edge = padded[6];
+	gene_distance_to_up_body = padded[7];
+	gene_distance_to_down_body = padded[8];
+	gene_distance_to_left_body = padded[9];
+	gene_distance_to_right_body = padded[10];
+	gene_reachable_area = padded[11];
+	gene_tail_reachable = padded[12];
 }
 
 //Creates a game and allows the genome to make all the decisions on actions until
@@ -56,6 +105,10 @@ void genome::randomize()
 int genome::play_game(const bool display, const int turn_limit, const int display_delay)
 {
 	game test_game;
+	//The tree search keeps its tree for the whole game
+	unique_ptr<mcts_planner> tree;
+	if(MCTS_SIMULATIONS > 0)
+		tree.reset(new mcts_planner(MCTS_SIMULATIONS, MCTS_ROLLOUT_DEPTH, MCTS_FOOD_SAMPLES, game_rand()));
 	//main game loop cut off by a turn_limit
 	for(int i = 0; i < turn_limit; i++)
 	{
@@ -70,7 +123,7 @@ int genome::play_game(const bool display, const int turn_limit, const int displa
 		}
 
 		//Determine the best action to take from the current state
-		coordinate action = optimize_action(test_game.current_state);
+		coordinate action = optimize_action(test_game.current_state, tree.get());
 
 		//Update the game by taking the selected action
 		test_game.update(action);
@@ -96,22 +149,38 @@ int genome::play_game(const bool display, const int turn_limit, const int displa
 
 //Depth limited Depth First Search of the game tree returning the action
 //that maximizes the heuristic value based on the genome's genes
-coordinate genome::optimize_action(state s)
+coordinate genome::optimize_action(state s, mcts_planner* tree)
 {
+	profile_scope scope(profiler, PHASE_OPTIMIZE_ACTION);
+	if(MCTS_SIMULATIONS > 0)
+	{
+		if(tree != nullptr)
+			return tree->choose(*this, s);
+		mcts_planner move_tree(MCTS_SIMULATIONS, MCTS_ROLLOUT_DEPTH, MCTS_FOOD_SAMPLES, game_rand());
+		return move_tree.choose(*this, s);
+	}
+	if(BEAM_WIDTH > 0)
+		return beam_action(s);
 	vector<coordinate> best_action;
 	coordinate current_action;
-	int best_heuristic = -10000;
+	//Starts below any heuristic value so large maps, where the loss penalty
+	//is large, still select an action
+	int best_heuristic = INT_MIN;
 	int current_heuristic;
 
 	//Determine possible actions
 	vector<coordinate> actions = s.actions();
 
+	//Determine the best heuristic value at the search depth for each action.
+	//The search draws no random numbers, since food in searched states comes
+	//from the game's food sequence, so serial and parallel searches agree.
+	vector<int> branch_heuristic(actions.size());
+	heuristic_plan plan = plan_heuristic(s);
+	search_root(s, actions, branch_heuristic, plan);
+
 	for(unsigned int i = 0; i < actions.size(); i++)
 	{
-		//Create a state from taking a possible action
-		state new_state = s.result(actions[i]);
-		//Determine the best heuristic value at the search depth
-		current_heuristic = optimize_heuristic_at_depth(new_state, SEARCH_DEPTH);
+		current_heuristic = branch_heuristic[i];
 		//If the new heuristic matches the best one found, they are both options
 		//to be chosen in the return
 		if(current_heuristic == best_heuristic)
@@ -129,7 +198,236 @@ coordinate genome::optimize_action(state s)
 	}
 
 	//Selects randomly from the best actions if there is a tie
-	return best_action[rand()%best_action.size()];
+	return best_action[game_rand()%best_action.size()];
+}
+
+//Fills branch_heuristic with the best heuristic value below each root action.
+//The top ROOT_SPLIT_PLIES plies are split into independent subtrees which run
+//on the search pool when one is set, or one after another otherwise.
+void genome::search_root(state& s, vector<coordinate>& actions, vector<int>& branch_heuristic, const heuristic_plan& plan)
+{
+	task_group search;
+	auto run = [this, &search](function<void()> work)
+	{
+		if(search_pool != nullptr)
+			search_pool->submit(search, work);
+		else
+			work();
+	};
+
+	if(ROOT_SPLIT_PLIES < 2)
+	{
+		//A serial search gives each action the best value found so far as
+		//its floor. An action below that is never chosen, so its value does
+		//not need to be exact.
+		int best_so_far = INT_MIN;
+		for(unsigned int i = 0; i < actions.size(); i++)
+		{
+			run([this, &s, &actions, &branch_heuristic, &plan, &best_so_far, i]()
+			{
+				state new_state = s.result(actions[i]);
+				int floor = search_pool == nullptr ? best_so_far : INT_MIN;
+				branch_heuristic[i] = search_at_depth(new_state, SEARCH_DEPTH, plan, floor);
+				if(search_pool == nullptr)
+					best_so_far = max(best_so_far, branch_heuristic[i]);
+			});
+		}
+		if(search_pool != nullptr)
+			search_pool->wait(search);
+		return;
+	}
+
+	//Split the second ply as well. The first ply states are cheap to create
+	//here, then each of their children becomes its own subtree.
+	vector<state> children;
+	vector<vector<coordinate>> child_actions(actions.size());
+	vector<vector<int>> child_heuristic(actions.size());
+	for(unsigned int i = 0; i < actions.size(); i++)
+	{
+		children.push_back(s.result(actions[i]));
+		if(children[i].loss)
+			continue;
+		child_actions[i] = children[i].actions();
+		child_heuristic[i].resize(child_actions[i].size());
+		for(unsigned int j = 0; j < child_actions[i].size(); j++)
+		{
+			run([this, &children, &child_actions, &child_heuristic, &plan, i, j]()
+			{
+				state new_state = children[i].result(child_actions[i][j]);
+				child_heuristic[i][j] = search_at_depth(new_state, SEARCH_DEPTH - 1, plan);
+			});
+		}
+	}
+	if(search_pool != nullptr)
+		search_pool->wait(search);
+
+	for(unsigned int i = 0; i < actions.size(); i++)
+	{
+		if(children[i].loss)
+		{
+			branch_heuristic[i] = planned_heuristic(children[i], plan);
+			continue;
+		}
+		branch_heuristic[i] = INT_MIN;
+		for(unsigned int j = 0; j < child_heuristic[i].size(); j++)
+		{
+			if(child_heuristic[i][j] > branch_heuristic[i])
+				branch_heuristic[i] = child_heuristic[i][j];
+		}
+	}
+}
+
+//A state kept by the beam search, the root action it descends from and its
+//heuristic value. Entries are only made from existing states, since a new
+//state would draw a food seed from game_rand.
+class beam_entry
+{
+	public:
+		state position;
+		int root;
+		int value;
+
+		beam_entry(const state& new_position, int new_root, int new_value = 0) : position(new_position)
+		{
+			root = new_root;
+			value = new_value;
+		}
+};
+
+//Hashes the body of a snake and the food tile. The body fixes the
+//direction and the score, but not the food, since two paths can reach the
+//same body having eaten at different times and so have had their food
+//placed over different open tiles.
+static uint64_t position_hash(state& s)
+{
+	uint64_t hash = 1469598103934665603ULL;
+	for(unsigned int i = 0; i < s.snake.size(); i++)
+	{
+		hash ^= s.snake[i].x * state::MAX_MAP_LIMIT + s.snake[i].y;
+		hash *= 1099511628211ULL;
+	}
+	hash ^= (s.food.x + 1) * (state::MAX_MAP_LIMIT + 1) + s.food.y + 1;
+	hash *= 1099511628211ULL;
+	return hash;
+}
+
+static bool same_position(state& a, state& b)
+{
+	if(a.snake.size() != b.snake.size() || a.food.x != b.food.x || a.food.y != b.food.y)
+		return false;
+	for(unsigned int i = 0; i < a.snake.size(); i++)
+	{
+		if(a.snake[i].x != b.snake[i].x || a.snake[i].y != b.snake[i].y)
+			return false;
+	}
+	return true;
+}
+
+//Beam search returning the root action that leads to the best state found
+//BEAM_DEPTH plies ahead. Each ply expands the states kept from the last one,
+//drops children whose snake and food already appeared in the ply, and
+//keeps the BEAM_WIDTH children with the highest heuristic values, so a move
+//costs BEAM_WIDTH * BEAM_DEPTH expansions rather than growing exponentially.
+//If every kept line ends in a loss, the action that survives the longest is
+//taken instead.
+coordinate genome::beam_action(state& s)
+{
+	vector<coordinate> actions = s.actions();
+	heuristic_plan plan = plan_heuristic(s);
+	vector<beam_entry> beam;
+	beam.push_back(beam_entry(s, -1));
+
+	//The deepest ply each root action reached before losing, and the best
+	//heuristic value of a loss at that ply
+	vector<int> loss_ply(actions.size(), -1);
+	vector<int> loss_value(actions.size(), INT_MIN);
+
+	for(int ply = 1; ply <= BEAM_DEPTH && !beam.empty(); ply++)
+	{
+		vector<beam_entry> children;
+		unordered_map<uint64_t, vector<int>> seen;
+		for(unsigned int i = 0; i < beam.size(); i++)
+		{
+			coordinate child_actions[state::MAX_ACTIONS];
+			int count = beam[i].position.actions(child_actions);
+			for(int j = 0; j < count; j++)
+			{
+				beam_entry child(beam[i].position.result(child_actions[j]), beam[i].root < 0 ? j : beam[i].root);
+				child.value = planned_heuristic(child.position, plan);
+				if(child.position.loss)
+				{
+					if(ply > loss_ply[child.root] || (ply == loss_ply[child.root] && child.value > loss_value[child.root]))
+					{
+						loss_ply[child.root] = ply;
+						loss_value[child.root] = child.value;
+					}
+					continue;
+				}
+
+				//The first copy of a state is kept, which comes from the
+				//better ranked parent
+				vector<int>& matches = seen[position_hash(child.position)];
+				bool duplicate = false;
+				for(unsigned int k = 0; k < matches.size() && !duplicate; k++)
+				{
+					duplicate = same_position(children[matches[k]].position, child.position);
+				}
+				if(duplicate)
+					continue;
+				matches.push_back(children.size());
+				children.push_back(child);
+			}
+		}
+
+		//Keep the best children, earlier ones first among equal values
+		vector<int> order(children.size());
+		for(unsigned int i = 0; i < order.size(); i++)
+		{
+			order[i] = i;
+		}
+		stable_sort(order.begin(), order.end(), [&children](int a, int b)
+		{
+			return children[a].value > children[b].value;
+		});
+		if((int)order.size() > BEAM_WIDTH)
+			order.resize(BEAM_WIDTH);
+		beam.clear();
+		for(unsigned int i = 0; i < order.size(); i++)
+		{
+			beam.push_back(children[order[i]]);
+		}
+	}
+
+	//Score each root action by its best surviving state, or by how long
+	//its lines lasted when none survived
+	vector<pair<int, int>> root_score(actions.size(), make_pair(-1, INT_MIN));
+	for(unsigned int i = 0; i < actions.size(); i++)
+	{
+		root_score[i] = make_pair(loss_ply[i], loss_value[i]);
+	}
+	for(unsigned int i = 0; i < beam.size(); i++)
+	{
+		pair<int, int> score = make_pair(BEAM_DEPTH + 1, beam[i].value);
+		if(score > root_score[beam[i].root])
+			root_score[beam[i].root] = score;
+	}
+
+	vector<coordinate> best_action;
+	pair<int, int> best_score = make_pair(-1, INT_MIN);
+	for(unsigned int i = 0; i < actions.size(); i++)
+	{
+		if(root_score[i] == best_score)
+			best_action.push_back(actions[i]);
+		else if(root_score[i] > best_score)
+		{
+			best_score = root_score[i];
+			best_action.clear();
+			best_action.push_back(actions[i]);
+		}
+	}
+
+	//Selects randomly from the best actions if there is a tie
+	return best_action[game_rand()%best_action.size()];
 }
 
 //Recursive function performing the depth limited depth first search
@@ -142,7 +440,7 @@ int genome::optimize_heuristic_at_depth(state s, int depth)
 		return heuristic(s);
 	}
 	coordinate current_action;
-	int best_heuristic = -100000;
+	int best_heuristic = INT_MIN;
 	int current_heuristic;
 
 	//Generate possible actions
@@ -164,6 +462,86 @@ int genome::optimize_heuristic_at_depth(state s, int depth)
 	return best_heuristic;
 }
 
+//Children that survive are searched first so they raise the floor. The
+//children that lose at once are then usually settled by the loss bound
+//without being built.
+template<class child_search>
+int genome::search_children(state& s, const heuristic_plan& plan, int floor, child_search child)
+{
+	int best_heuristic = INT_MIN;
+
+	coordinate actions[state::MAX_ACTIONS];
+	bool losing[state::MAX_ACTIONS];
+	int count = s.actions(actions);
+	for(int i = 0; i < count; i++)
+	{
+		losing[i] = s.loses(actions[i]);
+		if(losing[i])
+			continue;
+		state new_state = s.result(actions[i]);
+		int current_heuristic = child(new_state, max(floor, best_heuristic));
+		if(current_heuristic > best_heuristic)
+			best_heuristic = current_heuristic;
+	}
+	for(int i = 0; i < count; i++)
+	{
+		if(!losing[i])
+			continue;
+		int child_floor = max(floor, best_heuristic);
+		int current_heuristic = child_floor - 1;
+		if(!loss_below(s, plan, child_floor))
+		{
+			state new_state = s.result(actions[i]);
+			current_heuristic = child(new_state, child_floor);
+		}
+		if(current_heuristic > best_heuristic)
+			best_heuristic = current_heuristic;
+	}
+
+	return best_heuristic;
+}
+
+//The bottom of the compiled search is the heuristic itself
+template<>
+int genome::search<0>(state& s, const heuristic_plan& plan, int floor)
+{
+	return planned_heuristic(s, plan, floor);
+}
+
+//Returns the same value as optimize_heuristic_at_depth whenever that value
+//is at least floor
+template<int D>
+int genome::search(state& s, const heuristic_plan& plan, int floor)
+{
+	if(s.loss)
+		return planned_heuristic(s, plan, floor);
+	return search_children(s, plan, floor, [this, &plan](state& child, int child_floor)
+	{
+		return search<D - 1>(child, plan, child_floor);
+	});
+}
+
+const genome::search_function genome::SEARCH_TABLE[genome::UNROLLED_DEPTHS] =
+{
+	&genome::search<0>,
+	&genome::search<1>,
+	&genome::search<2>,
+	&genome::search<3>,
+	&genome::search<4>
+};
+
+int genome::search_at_depth(state& s, int depth, const heuristic_plan& plan, int floor)
+{
+	if(depth < UNROLLED_DEPTHS)
+		return (this->*SEARCH_TABLE[depth])(s, plan, floor);
+	if(s.loss)
+		return planned_heuristic(s, plan, floor);
+	return search_children(s, plan, floor, [this, depth, &plan](state& child, int child_floor)
+	{
+		return search_at_depth(child, depth - 1, plan, child_floor);
+	});
+}
+
 //adjusts the heuristic value by using the genes as weighted values
 //to adjust the importance of the helper functions related to each gene
 int genome::heuristic(state s)
@@ -196,6 +574,18 @@ int genome::heuristic(state s)
 
 	heuristic_sum += gene_distance_to_right_body * heur_distance_to_right_body(s);
 
+	//The flood fill is only run when one of the genes that use it has a weight
+	if(gene_reachable_area != 0 || gene_tail_reachable != 0)
+	{
+		bitboard reachable = reachable_tiles(s);
+
+		heuristic_sum += gene_reachable_area * heur_reachable_area(reachable);
+
+		//Reaching the tail is weighted like the score so that it can compete
+		//with the distance based genes
+		heuristic_sum += (s.MAP_X_LIMIT + s.MAP_Y_LIMIT) * gene_tail_reachable * heur_tail_reachable(s, reachable);
+	}
+
 	//A losing state is weighted by the product of the map limits so a loss
 	//is always weighted greater than what the other genes can produce
 	heuristic_sum += s.loss * -(s.MAP_X_LIMIT * s.MAP_Y_LIMIT);
@@ -203,38 +593,121 @@ int genome::heuristic(state s)
 	return heuristic_sum;
 }
 
+//The head position terms are cheap and always computed. The body rays and
+//the flood fill are only computed for genes with a weight. Every bound adds
+//two to each term's largest value for the truncation and rounding of the
+//sum.
+heuristic_plan genome::plan_heuristic(state& s)
+{
+	heuristic_plan plan;
+	const double TRUNCATION = 2;
+	plan.up_body = gene_distance_to_up_body != 0;
+	plan.down_body = gene_distance_to_down_body != 0;
+	plan.left_body = gene_distance_to_left_body != 0;
+	plan.right_body = gene_distance_to_right_body != 0;
+	plan.flood = gene_reachable_area != 0 || gene_tail_reachable != 0;
+
+	plan.ray_bound = (fabs(gene_distance_to_up_body) + fabs(gene_distance_to_down_body)) * (s.MAP_Y_LIMIT - 1)
+			+ (fabs(gene_distance_to_left_body) + fabs(gene_distance_to_right_body)) * (s.MAP_X_LIMIT - 1)
+			+ 4 * TRUNCATION;
+	plan.flood_bound = fabs(gene_reachable_area) * s.MAP_X_LIMIT * s.MAP_Y_LIMIT
+			+ fabs(gene_tail_reachable) * (s.MAP_X_LIMIT + s.MAP_Y_LIMIT) + 2 * TRUNCATION;
+
+	//A state made by result has a turn counter of one, and a losing move
+	//leaves the head where it was, still on the map
+	plan.loss_bound = -(s.MAP_X_LIMIT * s.MAP_Y_LIMIT) + fabs(gene_turn_count) + TRUNCATION
+			+ fabs(gene_distance_to_food) * (s.MAP_X_LIMIT + s.MAP_Y_LIMIT - 2) + TRUNCATION
+			+ (fabs(gene_distance_to_top_edge) + fabs(gene_distance_to_bottom_edge)) * (s.MAP_Y_LIMIT - 1)
+			+ (fabs(gene_distance_to_left_edge) + fabs(gene_distance_to_right_edge)) * (s.MAP_X_LIMIT - 1)
+			+ 4 * TRUNCATION + plan.ray_bound + plan.flood_bound;
+	return plan;
+}
+
+//Adds the same terms in the same order as heuristic, so the sum is the same
+//whenever it is finished. Before each expensive group of terms the sum so
+//far plus the bounds of the rest is compared with the floor.
+int genome::planned_heuristic(state& s, const heuristic_plan& plan, int floor)
+{
+	int heuristic_sum = 0;
+
+	heuristic_sum += gene_turn_count * s.turn;
+	heuristic_sum += (s.MAP_X_LIMIT + s.MAP_Y_LIMIT) * gene_score * s.score;
+	if(gene_distance_to_food != 0)
+		heuristic_sum += gene_distance_to_food * heur_distance_to_food(s);
+	if(gene_distance_to_top_edge != 0)
+		heuristic_sum += gene_distance_to_top_edge * heur_distance_to_top_edge(s);
+	if(gene_distance_to_bottom_edge != 0)
+		heuristic_sum += gene_distance_to_bottom_edge * heur_distance_to_bottom_edge(s);
+	if(gene_distance_to_left_edge != 0)
+		heuristic_sum += gene_distance_to_left_edge * heur_distance_to_left_edge(s);
+	if(gene_distance_to_right_edge != 0)
+		heuristic_sum += gene_distance_to_right_edge * heur_distance_to_right_edge(s);
+
+	int loss_penalty = s.loss * -(s.MAP_X_LIMIT * s.MAP_Y_LIMIT);
+	if(heuristic_sum + plan.ray_bound + plan.flood_bound + loss_penalty < floor)
+		return floor - 1;
+
+	if(plan.up_body)
+		heuristic_sum += gene_distance_to_up_body * heur_distance_to_up_body(s);
+	if(plan.down_body)
+		heuristic_sum += gene_distance_to_down_body * heur_distance_to_down_body(s);
+	if(plan.left_body)
+		heuristic_sum += gene_distance_to_left_body * heur_distance_to_left_body(s);
+	if(plan.right_body)
+		heuristic_sum += gene_distance_to_right_body * heur_distance_to_right_body(s);
+
+	if(plan.flood)
+	{
+		if(heuristic_sum + plan.flood_bound + loss_penalty < floor)
+			return floor - 1;
+		bitboard reachable = reachable_tiles(s);
+		heuristic_sum += gene_reachable_area * heur_reachable_area(reachable);
+		heuristic_sum += (s.MAP_X_LIMIT + s.MAP_Y_LIMIT) * gene_tail_reachable * heur_tail_reachable(s, reachable);
+	}
+
+	heuristic_sum += loss_penalty;
+	return heuristic_sum;
+}
+
+//A losing move keeps the score of the state it was made from
+bool genome::loss_below(state& s, const heuristic_plan& plan, int floor)
+{
+	double score_bound = fabs((s.MAP_X_LIMIT + s.MAP_Y_LIMIT) * gene_score * s.score) + 2;
+	return plan.loss_bound + score_bound < floor;
+}
+
 //returns the Manhattan distance from the snakes head to the food coordinate
-int genome::heur_distance_to_food(state s)
+int genome::heur_distance_to_food(state& s)
 {
 	return abs(s.snake.back().x - s.food.x) + abs(s.snake.back().y - s.food.y);
 }
 
 //returns the linear distance to the top edge from the snake's head
-int genome::heur_distance_to_top_edge(state s)
+int genome::heur_distance_to_top_edge(state& s)
 {
 	return s.snake.back().y;
 }
 
 //returns the linear distance to the bottom edge from the snake's head
-int genome::heur_distance_to_bottom_edge(state s)
+int genome::heur_distance_to_bottom_edge(state& s)
 {
 	return s.MAP_Y_LIMIT - 1 - s.snake.back().y;
 }
 
 //returns the linear distance to the left edge from the snake's head
-int genome::heur_distance_to_left_edge(state s)
+int genome::heur_distance_to_left_edge(state& s)
 {
 	return s.snake.back().x;
 }
 
 //returns the linear distance to the right edge from the snake's head
-int genome::heur_distance_to_right_edge(state s)
+int genome::heur_distance_to_right_edge(state& s)
 {
 	return s.MAP_X_LIMIT - 1 - s.snake.back().x;
 }
 
 //returns the linear distance to the nearest body segment or edge searching upwards
-int genome::heur_distance_to_up_body(state s)
+int genome::heur_distance_to_up_body(state& s)
 {
 	if(s.direction_modifier == coordinate(0,1))
 		return 0;
@@ -249,7 +722,7 @@ int genome::heur_distance_to_up_body(state s)
 }
 
 //returns the linear distance to the nearest body segment or edge searching downwards
-int genome::heur_distance_to_down_body(state s)
+int genome::heur_distance_to_down_body(state& s)
 {
 	if(s.direction_modifier == coordinate(0,-1))
 		return 0;
@@ -264,7 +737,7 @@ int genome::heur_distance_to_down_body(state s)
 }
 
 //returns the linear distance to the nearest body segment or edge searching leftwards
-int genome::heur_distance_to_left_body(state s)
+int genome::heur_distance_to_left_body(state& s)
 {
 	if(s.direction_modifier == coordinate(1,0))
 		return 0;
@@ -279,7 +752,7 @@ int genome::heur_distance_to_left_body(state s)
 }
 
 //returns the linear distance to the nearest body segment or edge searching upwards
-int genome::heur_distance_to_right_body(state s)
+int genome::heur_distance_to_right_body(state& s)
 {
 	if(s.direction_modifier == coordinate(-1,0))
 		return 0;
@@ -293,17 +766,36 @@ int genome::heur_distance_to_right_body(state s)
 	return s.MAP_X_LIMIT - 1 - s.snake.back().x;
 }
 
+//returns the tiles reachable from the snake's head by a bit parallel flood
+//fill over the open tiles of the map
+bitboard genome::reachable_tiles(state& s)
+{
+	bitboard open = s.open_tiles();
+	return open.flood_fill(s.snake.back().x, s.snake.back().y, open);
+}
+
+//returns the number of open tiles reachable from the snake's head, not
+//counting the head itself
+int genome::heur_reachable_area(bitboard& reachable)
+{
+	return reachable.count() - 1;
+}
+
+//returns 1 if the snake's head can reach its tail and 0 otherwise
+int genome::heur_tail_reachable(state& s, bitboard& reachable)
+{
+	if(s.snake.size() < 2)
+		return 1;
+	return reachable.test(s.snake.front().x, s.snake.front().y);
+}
+
 //updates and returns the fitness value of a genome's performance
 int genome::fitness(state s, int turn)
 {
-	//Score is weighted greater than the highest weighted turn value to
-	//isolate each factor's influence
-	const int SCORE_WEIGHT = 1000;
-	//The turn weight encourages generations to survive more turns
-	const int TURN_WEIGHT = 1;
-
 	//evaluate the weighted results of a game's results
 	fitness_value = s.score * SCORE_WEIGHT + turn * TURN_WEIGHT;
+	game_score = s.score;
+	game_turns = turn;
 
 	return s.score * SCORE_WEIGHT + turn * TURN_WEIGHT;
 }
@@ -323,6 +815,8 @@ void genome::display()
 	cout << "To Down Body: " << gene_distance_to_down_body << endl;
 	cout << "To Left Body: " << gene_distance_to_left_body << endl;
 	cout << "To Right Body: " << gene_distance_to_right_body << endl;
+	cout << "Reachable Area: " << gene_reachable_area << endl;
+	cout << "Tail Reachable: " << gene_tail_reachable << endl;
 	cout << "Fitness: " << fitness_value << endl;
 	return;
 }
@@ -347,6 +841,10 @@ void genome::save_to_file(const char* file_name)
 		file << gene_distance_to_left_body << endl;
 		file << gene_distance_to_right_body << endl;
 		file << fitness_value << endl;
+		//Genes added after the original format follow the fitness value so
+		//older genome files still load
+		file << gene_reachable_area << endl;
+		file << gene_tail_reachable << endl;
 		file.close();
 		cout << "Successfully saved genome to " << file_name << endl;
 	}
@@ -354,7 +852,7 @@ void genome::save_to_file(const char* file_name)
 }
 
 //Copies the values found in a file to the genes of a genome
-void genome::load_from_file(const char* file_name)
+bool genome::load_from_file(const char* file_name)
 {
 	ifstream file;
 	file.open(file_name);
@@ -373,10 +871,251 @@ void genome::load_from_file(const char* file_name)
 		file >> gene_distance_to_left_body;
 		file >> gene_distance_to_right_body;
 		file >> fitness_value;
+		bool complete = !file.fail();
+		//Older genome files end at the fitness value and leave these genes at zero
+		gene_reachable_area = 0;
+		gene_tail_reachable = 0;
+		file >> gene_reachable_area;
+		file >> gene_tail_reachable;
 		file.close();
-		cout << "Successfully loaded genome in " << file_name << endl;
+		if(complete)
+		{
+			cout << "Successfully loaded genome in " << file_name << endl;
+			return true;
+		}
+	}
+	cout << "Failed to load genome in " << file_name << endl;
+	return false;
+}
+
+evolution::evolution(const run_config& config, shared_ptr<scheduler> pool)
+{
+	POPULATION_SIZE = config.POPULATION_SIZE;
+	GENERATION_LIMIT = config.GENERATION_LIMIT;
+	MUTATION_CHANCE = config.MUTATION_CHANCE;
+	MUTATION_STEP = config.MUTATION_STEP;
+	ELITE_PROBABILITY_SLOPE = config.ELITE_PROBABILITY_SLOPE;
+	SEEDS_PER_GENOME = config.SEEDS_PER_GENOME;
+	TEST_TURNS = config.TEST_TURNS;
+	BATCH_SIMULATION = config.BATCH_SIMULATION != 0;
+	STEADY_STATE = config.STEADY_STATE != 0;
+	SURROGATE_EXPLORATION = config.SURROGATE_EXPLORATION;
+	DEDUPE_EPSILON = config.DEDUPE_EPSILON;
+	TARGET_FITNESS = config.TARGET_FITNESS;
+	BEAM_WIDTH = config.BEAM_WIDTH;
+	BEAM_DEPTH = config.BEAM_DEPTH;
+	MCTS_SIMULATIONS = config.MCTS_SIMULATIONS;
+	MCTS_ROLLOUT_DEPTH = config.MCTS_ROLLOUT_DEPTH;
+	MCTS_FOOD_SAMPLES = config.MCTS_FOOD_SAMPLES;
+	curriculum.START_TURNS = config.CURRICULUM_TURNS;
+	curriculum.FULL_TURNS = TEST_TURNS;
+	curriculum.RAISE_THRESHOLD = config.CURRICULUM_THRESHOLD;
+	curriculum.turn_limit = config.CURRICULUM_TURNS > 0 ? min(config.CURRICULUM_TURNS, TEST_TURNS) : TEST_TURNS;
+	monitor.PATIENCE = config.CONVERGENCE_PATIENCE;
+	monitor.RESTART_FRACTION = config.CONVERGENCE_RESTART_FRACTION;
+	monitor.RESTART_LIMIT = config.CONVERGENCE_RESTARTS;
+	monitor.DIVERSITY_FLOOR = config.CONVERGENCE_DIVERSITY;
+	if(config.SURROGATE)
+	{
+		surrogate = make_shared<surrogate_model>();
+		surrogate->NEIGHBOURS = config.SURROGATE_NEIGHBOURS;
+	}
+	breeding_engine.seed(config.SEED);
+	start_time = chrono::steady_clock::now();
+
+	workers = pool;
+	if(workers == nullptr)
+		workers = make_shared<scheduler>(config.THREADS);
+	if(config.PROCESSES > 0)
+		processes = make_shared<process_pool>(config.PROCESSES, config.PROCESS_TIMEOUT);
+	if(config.PROFILE)
+		profiler = make_shared<phase_profiler>();
+	if(config.OPTIMIZER == OPTIMIZER_CMA_ES)
+		breeding_optimizer = make_shared<cma_es>(genome::GENE_COUNT, POPULATION_SIZE);
+}
+
+//Spawns the first generation, then tests each generation and breeds the
+//next one until the generation limit. The last generation is tested too so
+//its fittest genome is at the back of the generation, always with the full
+//turn limit. The convergence monitor can end the run early or re-randomize
+//part of the next generation.
+void evolution::run()
+{
+	if(STEADY_STATE)
+	{
+		run_steady_state();
+		return;
+	}
+	initialize();
+	for(int i = 0; i <= GENERATION_LIMIT; i++)
+	{
+		if(i == GENERATION_LIMIT)
+			curriculum.turn_limit = curriculum.FULL_TURNS;
+		test_generation();
+		convergence_action action = monitor.update(generation.back().fitness_value,
+				generation[generation.size() / 2].fitness_value, gene_diversity());
+		if(verbose && monitor.PATIENCE > 0)
+			cout << "Gene Diversity: " << monitor.diversity.back() << endl;
+		//A projected fitness is not enough to end the run
+		if(TARGET_FITNESS > 0 && generation.back().fitness_value >= TARGET_FITNESS &&
+		   curriculum.limits.back() >= curriculum.FULL_TURNS)
+		{
+			if(verbose)
+				cout << "Reached the target fitness in generation " << i << " after "
+					 << games_played << " games" << endl;
+			break;
+		}
+		if(i == GENERATION_LIMIT)
+			break;
+		if(action == CONVERGENCE_STOP)
+		{
+			monitor.generations_saved = GENERATION_LIMIT - i;
+			if(verbose)
+				cout << "Stopped after generation " << i << " with no progress, saving "
+					 << monitor.generations_saved << " generations" << endl;
+			break;
+		}
+		spawn_next_generation();
+		if(action == CONVERGENCE_RESTART && breeding_optimizer != nullptr)
+		{
+			restart_optimizer();
+			if(verbose)
+				cout << "Progress stalled, restarted the optimizer for generation " << generation_number << endl;
+		}
+		else if(action == CONVERGENCE_RESTART)
+		{
+			randomize_part(monitor.RESTART_FRACTION);
+			if(verbose)
+				cout << "Progress stalled, re-randomized " << monitor.RESTART_FRACTION * 100
+					 << "% of generation " << generation_number << endl;
+		}
 	}
-	else cout << "Failed to load genome in " << file_name << endl;
+	if(verbose)
+		cout << "Simulated " << curriculum.turns_total << " turns over " << curriculum.limits.size()
+			 << " generations" << endl;
+}
+
+//Plays the fitness games of the generation in the configured way
+void evolution::test_generation()
+{
+	for(unsigned int i = 0; i < generation.size(); i++)
+	{
+		generation[i].profiler = profiler.get();
+		generation[i].BEAM_WIDTH = BEAM_WIDTH;
+		generation[i].BEAM_DEPTH = BEAM_DEPTH;
+		generation[i].MCTS_SIMULATIONS = MCTS_SIMULATIONS;
+		generation[i].MCTS_ROLLOUT_DEPTH = MCTS_ROLLOUT_DEPTH;
+		generation[i].MCTS_FOOD_SAMPLES = MCTS_FOOD_SAMPLES;
+	}
+	if(processes != nullptr)
+		fitness_test_processes(curriculum.turn_limit);
+	else if(BATCH_SIMULATION)
+		fitness_test_batch(curriculum.turn_limit);
+	else
+		fitness_test(false, curriculum.turn_limit);
+}
+
+//Keeps the POPULATION_SIZE fittest evaluated genomes ranked while a stream
+//of genomes is evaluated on the workers. As soon as a genome's games finish
+//it is ranked, displacing the least fit genome, and children bred from the
+//current elites are queued to keep every worker busy. No worker ever waits
+//for the slowest game of a generation.
+//Every genome plays the same seeds so fitness values found at different
+//times stay comparable. Breeding follows the order games finish in, so a
+//run is only reproducible with a single worker. The batch simulation is
+//not used since its lockstep turns are a barrier of their own.
+void evolution::run_steady_state()
+{
+	vector<unsigned int> seeds;
+	for(int j = 0; j < SEEDS_PER_GENOME; j++)
+	{
+		seeds.push_back(game_seed(j));
+	}
+	const int EVALUATION_LIMIT = POPULATION_SIZE * (GENERATION_LIMIT + 1);
+	//The number of queued genomes that keeps the workers from running dry
+	//between a genome finishing and its replacement being bred
+	const int QUEUED_TARGET = 2 * workers->size();
+
+	initialize();
+	vector<genome> unevaluated = generation;
+	generation.clear();
+	if(verbose)
+		workers->reset_utilization();
+
+	mutex population_lock;
+	task_group evaluation;
+	int dispatched = 0;
+	int evaluated = 0;
+	int queued = 0;
+
+	//Queues a genome's games. Called with the population lock held.
+	function<void(genome)> dispatch = [&](genome player)
+	{
+		dispatched++;
+		queued++;
+		player.profiler = profiler.get();
+		player.BEAM_WIDTH = BEAM_WIDTH;
+		player.BEAM_DEPTH = BEAM_DEPTH;
+		player.MCTS_SIMULATIONS = MCTS_SIMULATIONS;
+		player.MCTS_ROLLOUT_DEPTH = MCTS_ROLLOUT_DEPTH;
+		player.MCTS_FOOD_SAMPLES = MCTS_FOOD_SAMPLES;
+		workers->submit(evaluation, [&, player]() mutable
+		{
+			profile_scope scope(profiler.get(), PHASE_FITNESS_TEST);
+			int fitness_total = 0;
+			for(int j = 0; j < SEEDS_PER_GENOME; j++)
+			{
+				seed_game_rand(seeds[j]);
+				fitness_total += player.play_game(false, TEST_TURNS);
+			}
+			player.fitness_value = fitness_total / SEEDS_PER_GENOME;
+
+			lock_guard<mutex> guard(population_lock);
+			games_played += SEEDS_PER_GENOME;
+			queued--;
+			evaluated++;
+			generation.insert(upper_bound(generation.begin(), generation.end(), player), player);
+			if((int)generation.size() > POPULATION_SIZE)
+				generation.erase(generation.begin());
+
+			//Every POPULATION_SIZE evaluations count as a generation
+			if(evaluated % POPULATION_SIZE == 0)
+			{
+				generation_number = evaluated / POPULATION_SIZE - 1;
+				display_generation();
+				publish_generation(seeds[0]);
+				if(evaluated < EVALUATION_LIMIT)
+					previous_generations.push_back(generation);
+			}
+
+			//The elites are the top half of the genomes ranked so far
+			while(generation.size() >= 4 && queued < QUEUED_TARGET && dispatched < EVALUATION_LIMIT)
+			{
+				vector<genome> elites(generation.begin() + generation.size() / 2, generation.end());
+				vector<genome> parents = choose_parents(elites);
+				dispatch(mutate_child(spawn_child(parents[0], parents[1])));
+			}
+		});
+	};
+
+	{
+		lock_guard<mutex> guard(population_lock);
+		for(unsigned int i = 0; i < unevaluated.size(); i++)
+		{
+			dispatch(unevaluated[i]);
+		}
+	}
+	workers->wait(evaluation);
+
+	if(verbose)
+		workers->display_utilization();
+}
+
+//Values are kept within RAND_MAX so the existing scaling by RAND_MAX
+//still gives numbers between 0 and 1
+int evolution::breed_rand()
+{
+	return breeding_engine() % (static_cast<unsigned int>(RAND_MAX) + 1u);
 }
 
 //Spawns the number of genomes in a generation's population size
@@ -387,7 +1126,7 @@ void evolution::initialize()
 
 	for(int i = 0; i < POPULATION_SIZE; i++)
 	{
-		new_genome.randomize();
+		new_genome.randomize(breeding_engine);
 		new_genome.id = next_genome_id;
 		next_genome_id++;
 		generation.push_back(new_genome);
@@ -399,17 +1138,359 @@ void evolution::initialize()
 //values from those trials and the results are displayed.
 void evolution::fitness_test(const bool display, const int turn_limit)
 {
+	//Every (genome, seed) game is queued as its own task. Each task plays on
+	//a copy of the genome so concurrent games never share fitness values.
+	vector<vector<int>> seed_fitness(POPULATION_SIZE, vector<int>(SEEDS_PER_GENOME));
+	vector<vector<int>> seed_turns(POPULATION_SIZE, vector<int>(SEEDS_PER_GENOME));
+	task_group evaluation;
+	if(verbose)
+		workers->reset_utilization();
+	screen_generation();
+	for(int i = 0; i < POPULATION_SIZE; i++)
+	{
+		if(!genome_played[i])
+			continue;
+		for(int j = 0; j < SEEDS_PER_GENOME; j++)
+		{
+			unsigned int seed = game_seed(j);
+			workers->submit(evaluation, [this, &seed_fitness, &seed_turns, i, j, seed, display, turn_limit]()
+			{
+				profile_scope scope(profiler.get(), PHASE_FITNESS_TEST);
+				genome player = generation[i];
+				seed_game_rand(seed);
+				player.play_game(display, turn_limit);
+				seed_fitness[i][j] = curriculum.projected_fitness(player.game_score, player.game_turns, turn_limit);
+				seed_turns[i][j] = player.game_turns;
+			});
+		}
+	}
+	workers->wait(evaluation);
+
+	assign_fitness(seed_fitness, seed_turns);
+	if(verbose)
+		workers->display_utilization();
+}
+
+//Sends every (genome, seed) game to the worker processes. The workers seed
+//their games the same way as fitness_test, so the fitness values match.
+void evolution::fitness_test_processes(const int turn_limit)
+{
+	screen_generation();
+	vector<process_job> jobs;
+	for(int i = 0; i < POPULATION_SIZE; i++)
+	{
+		if(!genome_played[i])
+			continue;
+		vector<float> genes = generation[i].genes();
+		for(int j = 0; j < SEEDS_PER_GENOME; j++)
+		{
+			process_job job;
+			job.seed = game_seed(j);
+			job.turn_limit = turn_limit;
+			job.map_x = state::map_x_setting;
+			job.map_y = state::map_y_setting;
+			job.beam_width = BEAM_WIDTH;
+			job.beam_depth = BEAM_DEPTH;
+			job.mcts_simulations = MCTS_SIMULATIONS;
+			job.mcts_rollout_depth = MCTS_ROLLOUT_DEPTH;
+			job.mcts_food_samples = MCTS_FOOD_SAMPLES;
+			job.gene_count = genes.size();
+			copy(genes.begin(), genes.end(), job.genes);
+			jobs.push_back(job);
+		}
+	}
+	vector<process_result> results = processes->evaluate(jobs);
+
+	vector<vector<int>> seed_fitness(POPULATION_SIZE, vector<int>(SEEDS_PER_GENOME));
+	vector<vector<int>> seed_turns(POPULATION_SIZE, vector<int>(SEEDS_PER_GENOME));
+	int next_result = 0;
+	for(int i = 0; i < POPULATION_SIZE; i++)
+	{
+		if(!genome_played[i])
+			continue;
+		for(int j = 0; j < SEEDS_PER_GENOME; j++)
+		{
+			process_result& result = results[next_result++];
+			seed_fitness[i][j] = curriculum.projected_fitness(result.score, result.turns, turn_limit);
+			seed_turns[i][j] = result.turns;
+		}
+	}
+	assign_fitness(seed_fitness, seed_turns);
+	if(verbose && processes->restarts > 0)
+		cout << "Worker Restarts: " << processes->restarts << " Reissued Games: " << processes->reissued << endl;
+}
+
+//Plays every (genome, seed) game of the generation in one batch simulation.
+//Each turn the genomes choose actions for chunks of lanes on the workers,
+//then the batch advances all of the running games together.
+void evolution::fitness_test_batch(const int turn_limit)
+{
+	//The number of lanes whose actions are chosen by one task
+	const int LANES_PER_TASK = 8;
+
+	vector<unsigned int> seeds;
 	for(int i = 0; i < POPULATION_SIZE; i++)
 	{
-		generation[i].play_game(display, turn_limit);
+		for(int j = 0; j < SEEDS_PER_GENOME; j++)
+		{
+			seeds.push_back(game_seed(j));
+		}
 	}
+	batch_simulation batch;
+	batch.reset(seeds);
+	//The lockstep batch always plays the whole generation
+	genome_played.assign(POPULATION_SIZE, true);
+	duplicate_of.assign(POPULATION_SIZE, -1);
+	surrogate_prediction.assign(POPULATION_SIZE, 0);
+	surrogate_predicted = false;
+	deduplicated = 0;
+	surrogate_skipped = 0;
+
+	//Each game carries its own generator between turns, swapped in while its
+	//action is chosen, so its tie breaks and lookahead food do not depend on
+	//the worker that chose the action. It starts after the draw that seeded
+	//the game's food, where play_game's generator is when its search starts.
+	vector<minstd_rand> search_engine(seeds.size());
+	for(unsigned int game = 0; game < seeds.size(); game++)
+	{
+		search_engine[game].seed(seeds[game]);
+		search_engine[game].discard(1);
+	}
+	vector<int> action_x(seeds.size());
+	vector<int> action_y(seeds.size());
+
+	if(verbose)
+		workers->reset_utilization();
+	for(int t = 0; t < turn_limit && batch.active > 0; t++)
+	{
+		task_group decisions;
+		for(int first = 0; first < batch.active; first += LANES_PER_TASK)
+		{
+			workers->submit(decisions, [this, &batch, &search_engine, &action_x, &action_y, first]()
+			{
+				profile_scope scope(profiler.get(), PHASE_FITNESS_TEST);
+				int last = min(first + LANES_PER_TASK, batch.active);
+				for(int lane = first; lane < last; lane++)
+				{
+					int game = batch.game_index[lane];
+					swap_game_rand(search_engine[game]);
+					coordinate action = generation[game / SEEDS_PER_GENOME].optimize_action(batch.to_state(lane));
+					swap_game_rand(search_engine[game]);
+					action_x[lane] = action.x;
+					action_y[lane] = action.y;
+				}
+			});
+		}
+		workers->wait(decisions);
+		batch.step(action_x, action_y);
+	}
+	batch.finish();
+
+	vector<vector<int>> seed_fitness(POPULATION_SIZE, vector<int>(SEEDS_PER_GENOME));
+	vector<vector<int>> seed_turns(POPULATION_SIZE, vector<int>(SEEDS_PER_GENOME));
+	for(int game = 0; game < batch.game_count; game++)
+	{
+		seed_fitness[game / SEEDS_PER_GENOME][game % SEEDS_PER_GENOME] =
+			curriculum.projected_fitness(batch.final_score[game], batch.final_turn[game], turn_limit);
+		seed_turns[game / SEEDS_PER_GENOME][game % SEEDS_PER_GENOME] = batch.final_turn[game];
+	}
+
+	assign_fitness(seed_fitness, seed_turns);
+	if(verbose)
+		workers->display_utilization();
+}
+
+//Sets each genome's fitness to its mean fitness across all of its seeds,
+//then sorts and displays the generation. The lengths of the games played
+//are passed to the curriculum, which may raise the next turn limit.
+void evolution::assign_fitness(vector<vector<int>>& seed_fitness, vector<vector<int>>& seed_turns)
+{
+	vector<int> game_turns;
+	for(int i = 0; i < POPULATION_SIZE; i++)
+	{
+		//Genomes that were screened out already have their fitness or copy it
+		//in update_screening
+		if(!genome_played[i])
+			continue;
+		int fitness_total = 0;
+		for(int j = 0; j < SEEDS_PER_GENOME; j++)
+		{
+			fitness_total += seed_fitness[i][j];
+			game_turns.push_back(seed_turns[i][j]);
+		}
+		generation[i].fitness_value = fitness_total / SEEDS_PER_GENOME;
+	}
+	bool raised = curriculum.update(game_turns);
+	update_screening();
 	sort_generation();
-	cout << "Generation: " << generation_number << endl << "Sorted Fitness: ";
+	display_generation();
+	if(verbose && raised)
+		cout << "Raised the fitness game turn limit to " << curriculum.turn_limit << endl;
+	publish_generation(game_seed(0));
+}
+
+//Decides which genomes play their fitness games. A child within
+//DEDUPE_EPSILON of a genome that has played takes that genome's fitness, and
+//a child within DEDUPE_EPSILON of an earlier child of the same generation
+//waits for that child's result. Of the rest, once the surrogate model has
+//samples, a child plays if its predicted fitness reaches the elite cutoff of
+//the previous generation, or by chance at the exploration rate so the model
+//keeps learning about the regions it rates poorly.
+void evolution::screen_generation()
+{
+	genome_played.assign(POPULATION_SIZE, true);
+	duplicate_of.assign(POPULATION_SIZE, -1);
+	surrogate_prediction.assign(POPULATION_SIZE, 0);
+	deduplicated = 0;
+	surrogate_skipped = 0;
+
+	if(DEDUPE_EPSILON > 0)
+	{
+		gene_index generation_genes;
+		for(int i = 0; i < POPULATION_SIZE; i++)
+		{
+			vector<float> genes = generation[i].genes();
+			int match = evaluated_genes.nearest_within(genes, DEDUPE_EPSILON);
+			//A fitness projected from a shorter limit than this generation's
+			//is only an estimate, so the genome plays again
+			if(match >= 0 && evaluated_limits[match] != curriculum.turn_limit &&
+			   evaluated_limits[match] != curriculum.FULL_TURNS)
+				match = -1;
+			if(match >= 0)
+			{
+				generation[i].fitness_value = evaluated_genes.values[match];
+			}
+			else if((match = generation_genes.nearest_within(genes, DEDUPE_EPSILON)) >= 0)
+			{
+				duplicate_of[i] = generation_genes.values[match];
+			}
+			else
+			{
+				generation_genes.add(genes, i);
+				continue;
+			}
+			genome_played[i] = false;
+			deduplicated++;
+		}
+	}
+
+	surrogate_predicted = surrogate != nullptr && surrogate->ready() && generation_number > 0;
+	if(!surrogate_predicted)
+		return;
 	for(int i = 0; i < POPULATION_SIZE; i++)
+	{
+		if(!genome_played[i])
+			continue;
+		surrogate_prediction[i] = surrogate->predict(generation[i]);
+		if(surrogate_prediction[i] >= elite_cutoff)
+			continue;
+		if(breed_rand() / static_cast<float>(RAND_MAX) < SURROGATE_EXPLORATION)
+			continue;
+		genome_played[i] = false;
+		generation[i].fitness_value = surrogate_prediction[i];
+		surrogate_skipped++;
+	}
+}
+
+//Copies the fitness of the genomes that played to their duplicates, adds
+//the genomes that played to the gene index and the surrogate model's
+//samples, and reports the games saved and the prediction error
+void evolution::update_screening()
+{
+	int played = 0;
+	double error_total = 0;
+	for(int i = 0; i < POPULATION_SIZE; i++)
+	{
+		if(duplicate_of[i] >= 0)
+			generation[i].fitness_value = generation[duplicate_of[i]].fitness_value;
+		if(!genome_played[i])
+			continue;
+		played++;
+		error_total += fabs(surrogate_prediction[i] - generation[i].fitness_value);
+		if(DEDUPE_EPSILON > 0)
+		{
+			evaluated_genes.add(generation[i].genes(), generation[i].fitness_value);
+			evaluated_limits.push_back(curriculum.limits.back());
+		}
+		if(surrogate != nullptr)
+			surrogate->add(generation[i]);
+	}
+	deduplicated_total += deduplicated;
+	games_played += played * SEEDS_PER_GENOME;
+	surrogate_games_saved += surrogate_skipped * SEEDS_PER_GENOME;
+
+	if(!verbose)
+		return;
+	if(DEDUPE_EPSILON > 0)
+	{
+		cout << "Deduplicated: " << deduplicated << "/" << POPULATION_SIZE << " (Total " << deduplicated_total
+			 << ") Gene Index Size: " << evaluated_genes.size() << endl;
+	}
+	if(surrogate != nullptr)
+	{
+		cout << "Surrogate Evaluated: " << played << "/" << POPULATION_SIZE
+			 << " Games Saved: " << surrogate_skipped * SEEDS_PER_GENOME << " (Total " << surrogate_games_saved << ")";
+		if(surrogate_predicted && played > 0)
+			cout << " Mean Absolute Error: " << error_total / played;
+		cout << endl;
+	}
+}
+
+//Prints the sorted fitness values of the generation
+void evolution::display_generation()
+{
+	if(!verbose)
+		return;
+	cout << "Generation: " << generation_number << endl << "Sorted Fitness: ";
+	for(unsigned int i = 0; i < generation.size(); i++)
 	{
 		cout << generation[i].fitness_value << ",";
 	}
 	cout << endl;
+	//The steady state mode does not count its turns
+	if(!curriculum.turns_simulated.empty())
+		cout << "Turns Simulated: " << curriculum.turns_simulated.back() << " (Turn Limit "
+			 << curriculum.limits.back() << ")" << endl;
+	if(profiler != nullptr)
+		profiler->display();
+}
+
+//Publishes the sorted generation's statistics and its champion along with
+//the seed of one of the champion's games, which a viewer replays. Nothing
+//is drawn or waited for here, so watching a run does not slow it down.
+void evolution::publish_generation(unsigned int champion_seed)
+{
+	if(publisher == nullptr)
+		return;
+	snapshot_frame frame;
+	frame.generation = generation_number;
+	frame.best_fitness = generation.back().fitness_value;
+	frame.median_fitness = generation[generation.size() / 2].fitness_value;
+	frame.worst_fitness = generation.front().fitness_value;
+	frame.seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+	frame.champion_id = generation.back().id;
+	frame.game_seed = champion_seed;
+	//The limit the generation's games were played with, which the steady
+	//state mode does not record since it always plays TEST_TURNS
+	frame.turn_limit = curriculum.limits.empty() ? TEST_TURNS : curriculum.limits.back();
+	frame.map_x = state::map_x_setting;
+	frame.map_y = state::map_y_setting;
+	frame.beam_width = BEAM_WIDTH;
+	frame.beam_depth = BEAM_DEPTH;
+	frame.mcts_simulations = MCTS_SIMULATIONS;
+	frame.mcts_rollout_depth = MCTS_ROLLOUT_DEPTH;
+	frame.mcts_food_samples = MCTS_FOOD_SAMPLES;
+	vector<float> values = generation.back().genes();
+	frame.gene_count = values.size();
+	copy(values.begin(), values.end(), frame.genes);
+	publisher->publish(frame);
+}
+
+//Returns the seed of a fitness test game. Every genome in a generation
+//plays the same seeds so their fitness values are directly comparable.
+unsigned int evolution::game_seed(int seed_index)
+{
+	return static_cast<unsigned int>(generation_number) * 7919u + static_cast<unsigned int>(seed_index) * 104729u + 1u;
 }
 
 //Sorts the generation vector by their fitness values
@@ -418,6 +1499,56 @@ void evolution::sort_generation()
 	sort(generation.begin(), generation.end());
 }
 
+//Returns the standard deviation of each gene across the generation,
+//averaged over the genes
+double evolution::gene_diversity()
+{
+	vector<double> sum(genome::GENE_COUNT, 0);
+	vector<double> square_sum(genome::GENE_COUNT, 0);
+	for(unsigned int i = 0; i < generation.size(); i++)
+	{
+		vector<float> genes = generation[i].genes();
+		for(int j = 0; j < genome::GENE_COUNT; j++)
+		{
+			sum[j] += genes[j];
+			square_sum[j] += genes[j] * genes[j];
+		}
+	}
+	double deviation_total = 0;
+	for(int j = 0; j < genome::GENE_COUNT; j++)
+	{
+		double mean = sum[j] / generation.size();
+		deviation_total += sqrt(max(square_sum[j] / generation.size() - mean * mean, 0.0));
+	}
+	return deviation_total / genome::GENE_COUNT;
+}
+
+//Replaces the given share of the generation with new random genomes. The
+//children are not ordered yet, so the first ones are replaced.
+void evolution::randomize_part(float fraction)
+{
+	int count = fraction * generation.size();
+	for(int i = 0; i < count; i++)
+	{
+		generation[i] = genome();
+		generation[i].randomize(breeding_engine);
+		generation[i].id = next_genome_id;
+		next_genome_id++;
+		generation[i].generation_born = generation_number;
+	}
+}
+
+//The optimizer only learns from genomes it proposed, so instead of random
+//genomes it widens its own distribution and redraws the generation from it
+void evolution::restart_optimizer()
+{
+	breeding_optimizer->restart();
+	for(unsigned int i = 0; i < generation.size(); i++)
+	{
+		generation[i].set_genes(breeding_optimizer->ask(breeding_engine));
+	}
+}
+
 //Stores the current generation in the archive of previous generations.
 //Selects the top half of the generation based on fitness.
 //Selects two parents randomly
@@ -426,9 +1557,31 @@ void evolution::sort_generation()
 //This process repeats until a new generation is generated and labelled
 void evolution::spawn_next_generation()
 {
+	profile_scope scope(profiler.get(), PHASE_SPAWN_GENERATION);
 	//Record the current generation
 	previous_generations.push_back(generation);
 	vector<genome> elites = generation;
+	elite_cutoff = generation[POPULATION_SIZE / 2].fitness_value;
+
+	//The optimizer learns from the sorted generation and proposes the next
+	if(breeding_optimizer != nullptr)
+	{
+		breeding_optimizer->tell(generation);
+		if(verbose)
+			breeding_optimizer->display();
+		generation.clear();
+		for(int i = 0; i < POPULATION_SIZE; i++)
+		{
+			genome child;
+			child.set_genes(breeding_optimizer->ask(breeding_engine));
+			child.id = next_genome_id;
+			next_genome_id++;
+			child.generation_born = generation_number + 1;
+			generation.push_back(child);
+		}
+		generation_number++;
+		return;
+	}
 
 	//Erase the bottom half of the genomes from the elite
 	for(int i = 0; i < (POPULATION_SIZE/2); i++)
@@ -520,7 +1673,7 @@ vector<genome> evolution::choose_parents(vector<genome> elites)
 	//uses the probability vector just calculated to select parents randomly
 	//based on their given probabilities
 	for(int i = 0; i < 2; i++)
-		parents.push_back(elites[probability_vector_index_identify(rand())]);
+		parents.push_back(elites[probability_vector_index_identify(breed_rand())]);
 
 	return parents;
 }
@@ -551,8 +1704,11 @@ genome evolution::spawn_child(genome parent_a, genome parent_b)
 	child.fitness_value = 0;
 	child.id = next_genome_id;
 	next_genome_id++;
+	child.parent_a_id = parent_a.id;
+	child.parent_b_id = parent_b.id;
+	child.generation_born = generation_number + 1;
 
-	if(rand() % 2 == 0)
+	if(breed_rand() % 2 == 0)
 	{
 		child.gene_turn_count = parent_a.gene_turn_count;
 	}
@@ -561,7 +1717,7 @@ genome evolution::spawn_child(genome parent_a, genome parent_b)
 		child.gene_turn_count = parent_b.gene_turn_count;
 	}
 
-	if(rand() % 2 == 0)
+	if(breed_rand() % 2 == 0)
 	{
 		child.gene_score = parent_a.gene_score;
 	}
@@ -570,7 +1726,7 @@ genome evolution::spawn_child(genome parent_a, genome parent_b)
 		child.gene_score = parent_b.gene_score;
 	}
 
-	if(rand() % 2 == 0)
+	if(breed_rand() % 2 == 0)
 	{
 		child.gene_distance_to_food = parent_a.gene_distance_to_food;
 	}
@@ -579,7 +1735,7 @@ genome evolution::spawn_child(genome parent_a, genome parent_b)
 		child.gene_distance_to_food = parent_b.gene_distance_to_food;
 	}
 
-	if(rand() % 2 == 0)
+	if(breed_rand() % 2 == 0)
 	{
 		child.gene_distance_to_top_edge = parent_a.gene_distance_to_top_edge;
 	}
@@ -588,7 +1744,7 @@ genome evolution::spawn_child(genome parent_a, genome parent_b)
 		child.gene_distance_to_top_edge = parent_b.gene_distance_to_top_edge;
 	}
 
-	if(rand() % 2 == 0)
+	if(breed_rand() % 2 == 0)
 	{
 		child.gene_distance_to_bottom_edge = parent_a.gene_distance_to_bottom_edge;
 	}
@@ -597,7 +1753,7 @@ genome evolution::spawn_child(genome parent_a, genome parent_b)
 		child.gene_distance_to_bottom_edge = parent_b.gene_distance_to_bottom_edge;
 	}
 
-	if(rand() % 2 == 0)
+	if(breed_rand() % 2 == 0)
 	{
 		child.gene_distance_to_left_edge = parent_a.gene_distance_to_left_edge;
 	}
@@ -606,7 +1762,7 @@ genome evolution::spawn_child(genome parent_a, genome parent_b)
 		child.gene_distance_to_left_edge = parent_b.gene_distance_to_left_edge;
 	}
 
-	if(rand() % 2 == 0)
+	if(breed_rand() % 2 == 0)
 	{
 		child.gene_distance_to_right_edge = parent_a.gene_distance_to_right_edge;
 	}
@@ -615,7 +1771,7 @@ genome evolution::spawn_child(genome parent_a, genome parent_b)
 		child.gene_distance_to_right_edge = parent_b.gene_distance_to_right_edge;
 	}
 
-	if(rand() % 2 == 0)
+	if(breed_rand() % 2 == 0)
 	{
 		child.gene_distance_to_up_body = parent_a.gene_distance_to_up_body;
 	}
@@ -624,7 +1780,7 @@ genome evolution::spawn_child(genome parent_a, genome parent_b)
 		child.gene_distance_to_up_body = parent_b.gene_distance_to_up_body;
 	}
 
-	if(rand() % 2 == 0)
+	if(breed_rand() % 2 == 0)
 	{
 		child.gene_distance_to_down_body = parent_a.gene_distance_to_down_body;
 	}
@@ -633,7 +1789,7 @@ genome evolution::spawn_child(genome parent_a, genome parent_b)
 		child.gene_distance_to_down_body = parent_b.gene_distance_to_down_body;
 	}
 
-	if(rand() % 2 == 0)
+	if(breed_rand() % 2 == 0)
 	{
 		child.gene_distance_to_left_body = parent_a.gene_distance_to_left_body;
 	}
@@ -642,7 +1798,7 @@ genome evolution::spawn_child(genome parent_a, genome parent_b)
 		child.gene_distance_to_left_body = parent_b.gene_distance_to_left_body;
 	}
 
-	if(rand() % 2 == 0)
+	if(breed_rand() % 2 == 0)
 	{
 		child.gene_distance_to_right_body = parent_a.gene_distance_to_right_body;
 	}
@@ -651,6 +1807,24 @@ genome evolution::spawn_child(genome parent_a, genome parent_b)
 		child.gene_distance_to_right_body = parent_b.gene_distance_to_right_body;
 	}
 
+	if(breed_rand() % 2 == 0)
+	{
+		child.gene_reachable_area = parent_a.gene_reachable_area;
+	}
+	else
+	{
+		child.gene_reachable_area = parent_b.gene_reachable_area;
+	}
+
+	if(breed_rand() % 2 == 0)
+	{
+		child.gene_tail_reachable = parent_a.gene_tail_reachable;
+	}
+	else
+	{
+		child.gene_tail_reachable = parent_b.gene_tail_reachable;
+	}
+
 
 	return child;
 }
@@ -661,59 +1835,69 @@ genome evolution::spawn_child(genome parent_a, genome parent_b)
 //unchanged.
 genome evolution::mutate_child(genome child)
 {
-	if(static_cast<float>(rand())/static_cast<float>(RAND_MAX) < MUTATION_CHANCE)
+	if(static_cast<float>(breed_rand())/static_cast<float>(RAND_MAX) < MUTATION_CHANCE)
+	{
+		child.gene_turn_count = child.gene_turn_count + static_cast<float>(breed_rand())/static_cast<float>(RAND_MAX) * MUTATION_STEP * 2 - MUTATION_STEP;
+	}
+
+	if(static_cast<float>(breed_rand())/static_cast<float>(RAND_MAX) < MUTATION_CHANCE)
+	{
+		child.gene_score = child.gene_score + static_cast<float>(breed_rand())/static_cast<float>(RAND_MAX) * MUTATION_STEP * 2 - MUTATION_STEP;
+	}
+
+	if(static_cast<float>(breed_rand())/static_cast<float>(RAND_MAX) < MUTATION_CHANCE)
 	{
-		child.gene_turn_count = child.gene_turn_count + static_cast<float>(rand())/static_cast<float>(RAND_MAX) * MUTATION_STEP * 2 - MUTATION_STEP;
+		child.gene_distance_to_food = child.gene_distance_to_food + static_cast<float>(breed_rand())/static_cast<float>(RAND_MAX) * MUTATION_STEP * 2 - MUTATION_STEP;
 	}
 
-	if(static_cast<float>(rand())/static_cast<float>(RAND_MAX) < MUTATION_CHANCE)
+	if(static_cast<float>(breed_rand())/static_cast<float>(RAND_MAX) < MUTATION_CHANCE)
 	{
-		child.gene_score = child.gene_score + static_cast<float>(rand())/static_cast<float>(RAND_MAX) * MUTATION_STEP * 2 - MUTATION_STEP;
+		child.gene_distance_to_top_edge = child.gene_distance_to_top_edge + static_cast<float>(breed_rand())/static_cast<float>(RAND_MAX) * MUTATION_STEP * 2 - MUTATION_STEP;
 	}
 
-	if(static_cast<float>(rand())/static_cast<float>(RAND_MAX) < MUTATION_CHANCE)
+	if(static_cast<float>(breed_rand())/static_cast<float>(RAND_MAX) < MUTATION_CHANCE)
 	{
-		child.gene_distance_to_food = child.gene_distance_to_food + static_cast<float>(rand())/static_cast<float>(RAND_MAX) * MUTATION_STEP * 2 - MUTATION_STEP;
+		child.gene_distance_to_bottom_edge = child.gene_distance_to_bottom_edge + static_cast<float>(breed_rand())/static_cast<float>(RAND_MAX) * MUTATION_STEP * 2 - MUTATION_STEP;
 	}
 
-	if(static_cast<float>(rand())/static_cast<float>(RAND_MAX) < MUTATION_CHANCE)
+	if(static_cast<float>(breed_rand())/static_cast<float>(RAND_MAX) < MUTATION_CHANCE)
 	{
-		child.gene_distance_to_top_edge = child.gene_distance_to_top_edge + static_cast<float>(rand())/static_cast<float>(RAND_MAX) * MUTATION_STEP * 2 - MUTATION_STEP;
+		child.gene_distance_to_left_edge = child.gene_distance_to_left_edge + static_cast<float>(breed_rand())/static_cast<float>(RAND_MAX) * MUTATION_STEP * 2 - MUTATION_STEP;
 	}
 
-	if(static_cast<float>(rand())/static_cast<float>(RAND_MAX) < MUTATION_CHANCE)
+	if(static_cast<float>(breed_rand())/static_cast<float>(RAND_MAX) < MUTATION_CHANCE)
 	{
-		child.gene_distance_to_bottom_edge = child.gene_distance_to_bottom_edge + static_cast<float>(rand())/static_cast<float>(RAND_MAX) * MUTATION_STEP * 2 - MUTATION_STEP;
+		child.gene_distance_to_right_edge = child.gene_distance_to_right_edge + static_cast<float>(breed_rand())/static_cast<float>(RAND_MAX) * MUTATION_STEP * 2 - MUTATION_STEP;
 	}
 
-	if(static_cast<float>(rand())/static_cast<float>(RAND_MAX) < MUTATION_CHANCE)
+	if(static_cast<float>(breed_rand())/static_cast<float>(RAND_MAX) < MUTATION_CHANCE)
 	{
-		child.gene_distance_to_left_edge = child.gene_distance_to_left_edge + static_cast<float>(rand())/static_cast<float>(RAND_MAX) * MUTATION_STEP * 2 - MUTATION_STEP;
+		child.gene_distance_to_up_body = child.gene_distance_to_up_body + static_cast<float>(breed_rand())/static_cast<float>(RAND_MAX) * MUTATION_STEP * 2 - MUTATION_STEP;
 	}
 
-	if(static_cast<float>(rand())/static_cast<float>(RAND_MAX) < MUTATION_CHANCE)
+	if(static_cast<float>(breed_rand())/static_cast<float>(RAND_MAX) < MUTATION_CHANCE)
 	{
-		child.gene_distance_to_right_edge = child.gene_distance_to_right_edge + static_cast<float>(rand())/static_cast<float>(RAND_MAX) * MUTATION_STEP * 2 - MUTATION_STEP;
+		child.gene_distance_to_down_body = child.gene_distance_to_down_body + static_cast<float>(breed_rand())/static_cast<float>(RAND_MAX) * MUTATION_STEP * 2 - MUTATION_STEP;
 	}
 
-	if(static_cast<float>(rand())/static_cast<float>(RAND_MAX) < MUTATION_CHANCE)
+	if(static_cast<float>(breed_rand())/static_cast<float>(RAND_MAX) < MUTATION_CHANCE)
 	{
-		child.gene_distance_to_up_body = child.gene_distance_to_up_body + static_cast<float>(rand())/static_cast<float>(RAND_MAX) * MUTATION_STEP * 2 - MUTATION_STEP;
+		child.gene_distance_to_left_body = child.gene_distance_to_left_body + static_cast<float>(breed_rand())/static_cast<float>(RAND_MAX) * MUTATION_STEP * 2 - MUTATION_STEP;
 	}
 
-	if(static_cast<float>(rand())/static_cast<float>(RAND_MAX) < MUTATION_CHANCE)
+	if(static_cast<float>(breed_rand())/static_cast<float>(RAND_MAX) < MUTATION_CHANCE)
 	{
-		child.gene_distance_to_down_body = child.gene_distance_to_down_body + static_cast<float>(rand())/static_cast<float>(RAND_MAX) * MUTATION_STEP * 2 - MUTATION_STEP;
+		child.gene_distance_to_right_body = child.gene_distance_to_right_body + static_cast<float>(breed_rand())/static_cast<float>(RAND_MAX) * MUTATION_STEP * 2 - MUTATION_STEP;
 	}
 
-	if(static_cast<float>(rand())/static_cast<float>(RAND_MAX) < MUTATION_CHANCE)
+	if(static_cast<float>(breed_rand())/static_cast<float>(RAND_MAX) < MUTATION_CHANCE)
 	{
-		child.gene_distance_to_left_body = child.gene_distance_to_left_body + static_cast<float>(rand())/static_cast<float>(RAND_MAX) * MUTATION_STEP * 2 - MUTATION_STEP;
+		child.gene_reachable_area = child.gene_reachable_area + static_cast<float>(breed_rand())/static_cast<float>(RAND_MAX) * MUTATION_STEP * 2 - MUTATION_STEP;
 	}
 
-	if(static_cast<float>(rand())/static_cast<float>(RAND_MAX) < MUTATION_CHANCE)
+	if(static_cast<float>(breed_rand())/static_cast<float>(RAND_MAX) < MUTATION_CHANCE)
 	{
-		child.gene_distance_to_right_body = child.gene_distance_to_right_body + static_cast<float>(rand())/static_cast<float>(RAND_MAX) * MUTATION_STEP * 2 - MUTATION_STEP;
+		child.gene_tail_reachable = child.gene_tail_reachable + static_cast<float>(breed_rand())/static_cast<float>(RAND_MAX) * MUTATION_STEP * 2 - MUTATION_STEP;
 	}
 
 	return child;
@@ -5,12 +5,52 @@
  */
 
 #include <iostream>
+#include <chrono>
+#include <climits>
+#include <memory>
+#include <random>
+#include "convergencemonitor.h"
+#include "curriculum.h"
 #include "game.h"
+#include "geneindex.h"
+#include "runconfig.h"
+#include "scheduler.h"
 using namespace std;
 
 #ifndef EVOLUTIONARYFRAMEWORK_H_
 #define EVOLUTIONARYFRAMEWORK_H_
 
+class snapshot_ring;
+class phase_profiler;
+class optimizer;
+class surrogate_model;
+class process_pool;
+class mcts_planner;
+
+//The parts of genome::heuristic a genome needs, worked out from its genes.
+//Features with a weight of exactly zero are skipped. Features with small
+//weights are still computed, because every term of the heuristic is
+//truncated to an integer as it is added and even a tiny weight can move
+//the sum by one. The bounds limit what the remaining terms can add, so a
+//searched state that cannot beat its siblings is given up early.
+class heuristic_plan
+{
+	public:
+		//Whether each feature past the cheap head position terms is needed
+		bool up_body = false;
+		bool down_body = false;
+		bool left_body = false;
+		bool right_body = false;
+		bool flood = false;
+		//Upper bounds on what the body ray terms and the flood fill terms
+		//can add to the sum
+		double ray_bound = 0;
+		double flood_bound = 0;
+		//An upper bound on the value of a state that has just lost, apart
+		//from its score term
+		double loss_bound = 0;
+};
+
 //A genome contains several genes and is evolved over time
 class genome
 {
@@ -18,6 +58,20 @@ class genome
 		//The search depth is how many turns ahead a genome can look
 		//while playing a game
 		static const int SEARCH_DEPTH = 2;
+		//The number of plies below the root that are split into separate
+		//subtrees. Deeper searches split one more ply so there are enough
+		//subtrees to keep a thread pool busy.
+		static const int ROOT_SPLIT_PLIES = SEARCH_DEPTH >= 3 ? 2 : 1;
+		//When above zero, moves are chosen by a beam search that keeps the
+		//BEAM_WIDTH best states of each ply out to BEAM_DEPTH plies instead
+		//of the exhaustive search to SEARCH_DEPTH
+		int BEAM_WIDTH = 0;
+		int BEAM_DEPTH = 12;
+		//When above zero, moves are chosen by a Monte Carlo tree search of
+		//MCTS_SIMULATIONS simulations, see mcts_planner
+		int MCTS_SIMULATIONS = 0;
+		int MCTS_ROLLOUT_DEPTH = 6;
+		int MCTS_FOOD_SAMPLES = 4;
 
 		//These are the characteristics that the genome uses to
 		//make decisions in a game
@@ -48,19 +102,83 @@ class genome
 		float gene_distance_to_left_body;
 		//The linear distance from the snake head to the nearest body segment or edge searching rightwards
 		float gene_distance_to_right_body;
+		//The number of open tiles the snake head can reach without crossing its body
+		float gene_reachable_area = 0;
+		//Whether the snake head can still reach its own tail
+		float gene_tail_reachable = 0;
+
+		//The number of genes, in the order the genes are declared above
+		static const int GENE_COUNT = 13;
+
+		//Score is weighted greater than the highest weighted turn value to
+		//isolate each factor's influence in the fitness
+		static const int SCORE_WEIGHT = 1000;
+		//The turn weight encourages generations to survive more turns
+		static const int TURN_WEIGHT = 1;
 
 		//The fitness of the genome
 		int fitness_value = 0;
+		//The score and number of turns of the last game the genome played
+		int game_score = 0;
+		int game_turns = 0;
+
+		//Lineage of the genome. Genomes of the first generation and genomes
+		//loaded from text files have no parents.
+		int parent_a_id = -1;
+		int parent_b_id = -1;
+		int generation_born = 0;
+
+		//When set, the subtrees below the root of each move are searched
+		//concurrently on this pool. The chosen action is the same either way.
+		scheduler* search_pool = nullptr;
+		//When set, the counters of each move's search are added to this
+		//profiler's optimize_action phase
+		phase_profiler* profiler = nullptr;
 
 		//Function to initialize a random genome
-		void randomize();
+		void randomize(minstd_rand& engine);
+
+		//Functions to read and write all of the genes as one vector in the
+		//order they are declared
+		vector<float> genes();
+		void set_genes(const vector<float>& values);
 
 		//Functions to play a game and select an action
 		int play_game(const bool display = false, const int turn_limit = 500, const int display_delay = 0);
-		coordinate optimize_action(state s);
+		//A game played with the tree search passes its planner, so the tree
+		//is kept from one move to the next. Without one each move starts a
+		//new tree.
+		coordinate optimize_action(state s, mcts_planner* tree = nullptr);
+		void search_root(state& s, vector<coordinate>& actions, vector<int>& branch_heuristic, const heuristic_plan& plan);
 		int optimize_heuristic_at_depth(state s, int depth);
+		coordinate beam_action(state& s);
 		int heuristic(state s);
 
+		//Builds the evaluation plan of the genome's current genes for the
+		//map of the given state
+		heuristic_plan plan_heuristic(state& s);
+		//Returns heuristic(s) if it is at least floor, or some value below
+		//floor, computing only what the plan needs to tell which
+		int planned_heuristic(state& s, const heuristic_plan& plan, int floor = INT_MIN);
+		//Returns true if every state losing immediately after s is below floor
+		bool loss_below(state& s, const heuristic_plan& plan, int floor);
+
+		//The same search with the depth fixed at compile time. Each depth is
+		//its own function, so the compiler can unroll the branching and
+		//inline the leaf heuristic, and no level allocates. The value is
+		//exact when it is at least floor and below floor otherwise, so
+		//siblings that cannot win are cut short.
+		template<int D> int search(state& s, const heuristic_plan& plan, int floor);
+		//The depths with a compiled search, from zero up
+		static const int UNROLLED_DEPTHS = 5;
+		typedef int (genome::*search_function)(state& s, const heuristic_plan& plan, int floor);
+		static const search_function SEARCH_TABLE[UNROLLED_DEPTHS];
+		//Runs the compiled search for the depth from the table. Deeper
+		//searches recurse until they reach a compiled depth.
+		int search_at_depth(state& s, int depth, const heuristic_plan& plan, int floor = INT_MIN);
+		//Returns the best value of child_search over the children of s
+		template<class child_search> int search_children(state& s, const heuristic_plan& plan, int floor, child_search child);
+
 		//Evaluates the effectiveness of the genome after playing a game
 		int fitness(state s, int turn);
 
@@ -68,19 +186,23 @@ class genome
 		void display();
 
 		//Gene calculation helper functions
-		int heur_distance_to_food(state s);
-		int heur_distance_to_top_edge(state s);
-		int heur_distance_to_bottom_edge(state s);
-		int heur_distance_to_left_edge(state s);
-		int heur_distance_to_right_edge(state s);
-		int heur_distance_to_up_body(state s);
-		int heur_distance_to_down_body(state s);
-		int heur_distance_to_left_body(state s);
-		int heur_distance_to_right_body(state s);
-
-		//Long Term Storage Saving/Loading
+		int heur_distance_to_food(state& s);
+		int heur_distance_to_top_edge(state& s);
+		int heur_distance_to_bottom_edge(state& s);
+		int heur_distance_to_left_edge(state& s);
+		int heur_distance_to_right_edge(state& s);
+		int heur_distance_to_up_body(state& s);
+		int heur_distance_to_down_body(state& s);
+		int heur_distance_to_left_body(state& s);
+		int heur_distance_to_right_body(state& s);
+		bitboard reachable_tiles(state& s);
+		int heur_reachable_area(bitboard& reachable);
+		int heur_tail_reachable(state& s, bitboard& reachable);
+
+		//Long Term Storage Saving/Loading. Loading returns false if the file
+		//cannot be read.
 		void save_to_file(const char* file_name = "last_best_genome.txt");
-		void load_from_file(const char* file_name = "last_best_genome.txt");
+		bool load_from_file(const char* file_name = "last_best_genome.txt");
 };
 
 //The evolution class maintains and updates generations of genomes
@@ -88,17 +210,56 @@ class genome
 class evolution
 {
 	public:
-		//Fixed values to influence how extensive the evolution process is
-		const int POPULATION_SIZE = 30;
-		const int GENERATION_LIMIT = 40;
+		//Values to influence how extensive the evolution process is. They
+		//are taken from the run_config the evolution is created with.
+		int POPULATION_SIZE = 30;
+		int GENERATION_LIMIT = 40;
 		//Mutation chance determines the percentage chance that a new gene is mutated
-		const float MUTATION_CHANCE = 0.05;
+		float MUTATION_CHANCE = 0.05;
 		//The mutation step determines the range a mutation can take from the
 		//original value +/- the step
-		const float MUTATION_STEP = 0.2;
+		float MUTATION_STEP = 0.2;
 		//Determines the slope of the probability vector linear adjustment if selected
 		//as the method of vector creation
-		const float ELITE_PROBABILITY_SLOPE = 0.01;
+		float ELITE_PROBABILITY_SLOPE = 0.01;
+		//The number of differently seeded games each genome plays during a
+		//fitness test. The genome's fitness is the mean over those games.
+		int SEEDS_PER_GENOME = 1;
+		//The turn cutoff of fitness test games and whether they are played
+		//in a lockstep batch simulation
+		int TEST_TURNS = 500;
+		bool BATCH_SIMULATION = false;
+		//Evolves without generation barriers, see run_steady_state
+		bool STEADY_STATE = false;
+		//The share of the children predicted to miss the elites that still
+		//play their games when the surrogate model is used
+		float SURROGATE_EXPLORATION = 0.2;
+		//Ends the run once the fittest genome reaches this fitness, when above
+		//zero, and the number of fitness games played so far
+		int TARGET_FITNESS = 0;
+		long long games_played = 0;
+		//The planner settings given to every genome that plays, see genome
+		int BEAM_WIDTH = 0;
+		int BEAM_DEPTH = 12;
+		int MCTS_SIMULATIONS = 0;
+		int MCTS_ROLLOUT_DEPTH = 6;
+		int MCTS_FOOD_SAMPLES = 4;
+
+		//Prints each generation's fitness and worker utilization
+		bool verbose = true;
+
+		//Watches the fitness and diversity of each generation to stop the
+		//run or re-randomize part of it when progress stalls
+		convergence_monitor monitor;
+		//Sets the turn limit of each generation's fitness games, which
+		//starts short when CURRICULUM_TURNS is set, and counts the turns
+		//played. The steady state mode always plays TEST_TURNS.
+		turn_curriculum curriculum;
+
+		//When set, each generation's statistics and champion are published
+		//to this ring for a viewer in another process
+		snapshot_ring* publisher = nullptr;
+		chrono::steady_clock::time_point start_time;
 
 		//Labels and containers for generation storage
 		int next_genome_id = 0;
@@ -111,13 +272,85 @@ class evolution
 		//in the choose_parents function.
 		vector<float> elite_probability_vector;
 
+		//Worker pool that plays the fitness test games. Every game is a
+		//separate task so short games never hold up a worker. Evolutions
+		//running side by side can share one pool to share the processors.
+		shared_ptr<scheduler> workers;
+		//When set, the fitness test games are played by these worker
+		//processes instead, so a crashing game cannot end the run
+		shared_ptr<process_pool> processes;
+		//When set, the fitness games, the searches and the breeding of each
+		//generation are measured and printed with the generation's fitness.
+		//Games played in worker processes are not measured.
+		shared_ptr<phase_profiler> profiler;
+		//When set, each generation after the first is proposed by this
+		//optimizer instead of the genetic algorithm in spawn_next_generation.
+		//The steady state mode always uses the genetic algorithm.
+		shared_ptr<optimizer> breeding_optimizer;
+
+		//Whether each genome of the generation plays its fitness games. The
+		//others take their fitness from a genome that did, or from the
+		//surrogate model.
+		vector<bool> genome_played;
+
+		//Children within DEDUPE_EPSILON of a genome that has played reuse its
+		//fitness instead of playing. Every genome that plays is added to the
+		//index, so it covers the current and all previous generations.
+		float DEDUPE_EPSILON = 0;
+		gene_index evaluated_genes;
+		//The turn limit each indexed fitness was played with
+		vector<int> evaluated_limits;
+		//The genome of the same generation whose fitness a child reuses, or -1
+		vector<int> duplicate_of;
+		int deduplicated = 0;
+		long long deduplicated_total = 0;
+
+		//When set, children that the surrogate model predicts will not reach
+		//the previous generation's elite cutoff skip their games and take the
+		//predicted fitness. The model learns from every genome that plays.
+		shared_ptr<surrogate_model> surrogate;
+		int elite_cutoff = 0;
+		vector<double> surrogate_prediction;
+		bool surrogate_predicted = false;
+		int surrogate_skipped = 0;
+		long long surrogate_games_saved = 0;
+
+		//Generator used for breeding so that runs in the same process do not
+		//disturb each other's random numbers
+		minstd_rand breeding_engine;
+
+		//Creates an evolution with the given settings. Without a pool the
+		//evolution starts one worker per hardware thread.
+		evolution(const run_config& config = run_config(), shared_ptr<scheduler> pool = nullptr);
+
+		//Evolves GENERATION_LIMIT generations and fitness tests the last one
+		void run();
+		//Evolves a ranked population with a continuous stream of children,
+		//evaluating as many genomes as GENERATION_LIMIT generations would
+		void run_steady_state();
+
+		//Returns a random number between 0 and RAND_MAX from the breeding generator
+		int breed_rand();
+
 		//Functions for testing genome fitness
 		void initialize();
+		void test_generation();
 		void fitness_test(const bool display = false, const int turn_limit = 500);
+		void fitness_test_batch(const int turn_limit = 500);
+		void fitness_test_processes(const int turn_limit = 500);
+		void assign_fitness(vector<vector<int>>& seed_fitness, vector<vector<int>>& seed_turns);
+		void screen_generation();
+		void update_screening();
+		void display_generation();
+		void publish_generation(unsigned int champion_seed);
+		unsigned int game_seed(int seed_index);
 
 		//Functions using the results of fitness testing to determine the evolution
 		//of the next generation from the best previous genomes.
 		void sort_generation();
+		double gene_diversity();
+		void randomize_part(float fraction);
+		void restart_optimizer();
 		void spawn_next_generation();
 		vector<genome> choose_parents(vector<genome> elites);
 		int probability_vector_index_identify(float random_num);
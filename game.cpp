@@ -3,36 +3,99 @@
  * This file contains the function implementations for the state and game classes
  */
 #include <iostream>
+#include <random>
+#include <string>
 #include "game.h"
 using namespace std;
 
-state::state()
+//The generator behind game_rand, one per thread
+static thread_local minstd_rand game_random_engine;
+
+int game_rand()
+{
+	return game_random_engine();
+}
+
+void seed_game_rand(unsigned int seed)
+{
+	game_random_engine.seed(seed);
+}
+
+void swap_game_rand(minstd_rand& engine)
+{
+	swap(game_random_engine, engine);
+}
+
+food_sequence::food_sequence(unsigned int seed)
 {
+	engine.seed(seed);
+}
+
+unsigned int food_sequence::at(int n)
+{
+	lock_guard<mutex> guard(lock);
+	while(static_cast<int>(values.size()) <= n)
+	{
+		values.push_back(engine());
+	}
+	return values[n];
+}
+
+//The default map is 25 by 15 tiles
+int state::map_x_setting = 25;
+int state::map_y_setting = 15;
+
+state::state(shared_ptr<food_sequence> source)
+{
+	food_source = source;
+	if(food_source == nullptr)
+		food_source = make_shared<food_sequence>(game_rand());
 	score = 0;
 	turn = 0;
 	loss = false;
 	direction_modifier = coordinate(1,0);
+	occupied = bitboard(MAP_X_LIMIT, MAP_Y_LIMIT);
 	for(int i = 0; i < START_SIZE; i++)
 	{
 		snake.push_back(coordinate(i,0));
+		occupied.set(i, 0);
 	}
 	place_food();
 }
 
-//Randomly generates a new coordinate to host the food which is not
-//currently occupied by any piece of the snake
+//The snake starts along the top row, so the map must be wider than the
+//starting snake
+bool state::set_map_size(int map_x_limit, int map_y_limit)
+{
+	if(map_x_limit <= 5 || map_y_limit < 1 ||
+	   map_x_limit > MAX_MAP_LIMIT || map_y_limit > MAX_MAP_LIMIT)
+		return false;
+	map_x_setting = map_x_limit;
+	map_y_setting = map_y_limit;
+	return true;
+}
+
+//Places the food on a random tile which is not currently occupied by any
+//piece of the snake. The game's food sequence entry for the current score
+//picks the nth open tile, so the cost does not grow as the snake fills the
+//map and no randomness is consumed. A full map has no food.
 void state::place_food()
 {
-	int random_x;
-	int random_y;
-	coordinate new_coord;
-	do
+	place_food(food_source->at(score));
+}
+
+void state::place_food(unsigned int draw)
+{
+	int open_count = MAP_X_LIMIT * MAP_Y_LIMIT - snake.size();
+	if(open_count <= 0)
 	{
-		random_x = rand() % MAP_X_LIMIT;
-		random_y = rand() % MAP_Y_LIMIT;
-		new_coord = coordinate(random_x, random_y);
-	}while(in_snake(new_coord));
-	food = new_coord;
+		food = coordinate(-1,-1);
+		return;
+	}
+	int x;
+	int y;
+	occupied.nth_clear(draw % open_count, x, y);
+	food = coordinate(x, y);
 }
 
 //returns a list of all the possible actions the user can take
@@ -40,6 +103,13 @@ void state::place_food()
 //The result is deterministic based on the current direction
 //of movement.
 vector<coordinate> state::actions()
+{
+	coordinate possible_actions[MAX_ACTIONS];
+	int count = actions(possible_actions);
+	return vector<coordinate>(possible_actions, possible_actions + count);
+}
+
+int state::actions(coordinate (&possible_actions)[MAX_ACTIONS])
 {
 	//Possible actions are unit vectors for
 	//the cardinal directions
@@ -48,44 +118,59 @@ vector<coordinate> state::actions()
 	const coordinate LEFT = coordinate(-1,0);
 	const coordinate RIGHT = coordinate(1,0);
 
-	vector<coordinate> possible_actions;
-
 	//The possible actions are turning left, right, or
 	//continuing in the current direction
 	if(direction_modifier == UP)
 	{
-		possible_actions.push_back(UP);
-		possible_actions.push_back(LEFT);
-		possible_actions.push_back(RIGHT);
+		possible_actions[0] = UP;
+		possible_actions[1] = LEFT;
+		possible_actions[2] = RIGHT;
 	}
 	else if(direction_modifier == DOWN)
 	{
-		possible_actions.push_back(DOWN);
-		possible_actions.push_back(LEFT);
-		possible_actions.push_back(RIGHT);
+		possible_actions[0] = DOWN;
+		possible_actions[1] = LEFT;
+		possible_actions[2] = RIGHT;
 	}
 	else if(direction_modifier == LEFT)
 	{
-		possible_actions.push_back(UP);
-		possible_actions.push_back(LEFT);
-		possible_actions.push_back(DOWN);
+		possible_actions[0] = UP;
+		possible_actions[1] = LEFT;
+		possible_actions[2] = DOWN;
 	}
 	else if(direction_modifier == RIGHT)
 	{
-		possible_actions.push_back(UP);
-		possible_actions.push_back(DOWN);
-		possible_actions.push_back(RIGHT);
+		possible_actions[0] = UP;
+		possible_actions[1] = DOWN;
+		possible_actions[2] = RIGHT;
 	}
+	else
+		return 0;
+
+	return MAX_ACTIONS;
+}
 
-	return possible_actions;
+//Follows the same order of tests as result, where moving onto the food is
+//never a loss
+bool state::loses(coordinate action)
+{
+	coordinate new_position = coordinate(snake.back().x + action.x, snake.back().y + action.y);
+	if(food == new_position)
+		return false;
+	if(new_position.x >= MAP_X_LIMIT || new_position.y >= MAP_Y_LIMIT ||
+	   new_position.x < 0 || new_position.y < 0)
+		return true;
+	return in_snake(new_position);
 }
 
 //returns the current state after it has taken the provided action
 state state::result(coordinate action)
 {
-	//Create a new state
-	state new_state;
-	new_state = *this;
+	//Create a new state as a copy of this one. Assignment has never carried
+	//the turn counter over, so the copy's counter is cleared to keep the
+	//heuristic's turn term as it has always been.
+	state new_state(*this);
+	new_state.turn = 0;
 	//Update the direction based on the action taken
 	new_state.direction_modifier = action;
 	//Increment the turn counter
@@ -96,6 +181,7 @@ state state::result(coordinate action)
 	if(new_state.food == new_position)
 	{
 		new_state.snake.push_back(new_position);
+		new_state.occupied.set(new_position.x, new_position.y);
 		new_state.score++;
 		new_state.place_food();
 	}
@@ -114,8 +200,10 @@ state state::result(coordinate action)
 	//is removed to maintain the body length
 	else
 	{
-		new_state.snake.push_back(new_position);
+		new_state.occupied.reset(new_state.snake.front().x, new_state.snake.front().y);
 		new_state.snake.erase(new_state.snake.begin());
+		new_state.snake.push_back(new_position);
+		new_state.occupied.set(new_position.x, new_position.y);
 	}
 	//returns the independent new state
 	return new_state;
@@ -125,28 +213,32 @@ state state::result(coordinate action)
 //to the standard output
 void state::display()
 {
+	//Each row is built as a string so large maps are written in a
+	//single call per row
+	string row;
 	for(int i = 0; i < MAP_Y_LIMIT; i++)
 	{
+		row.clear();
 		for(int j = 0; j < MAP_X_LIMIT; j++)
 		{
 			coordinate current_coord = coordinate(j,i);
 			//Print snake body segments
-			if(in_snake(current_coord))
+			if(occupied.test(j,i))
 			{
-				cout << "S";
+				row += 'S';
 			}
 			//Print the food tile
 			else if(current_coord == food)
 			{
-				cout << "F";
+				row += 'F';
 			}
 			//Print empty spaces
 			else
 			{
-				cout << "-";
+				row += '-';
 			}
 		}
-		cout << endl;
+		cout << row << endl;
 	}
 	cout << endl;
 	if(loss)
@@ -158,21 +250,36 @@ void state::display()
 }
 
 //returns true if the provided coordinate is part of the snake
-//returns false otherwise
+//returns false otherwise, including for coordinates off the map
 bool state::in_snake(coordinate& c)
 {
-	for(unsigned int i = 0; i < snake.size(); i++)
+	if(c.x < 0 || c.y < 0 || c.x >= MAP_X_LIMIT || c.y >= MAP_Y_LIMIT)
+		return false;
+	return occupied.test(c.x, c.y);
+}
+
+//returns a bitboard of every map tile not covered by the snake, treating
+//the tail segment as open
+bitboard state::open_tiles()
+{
+	bitboard open(MAP_X_LIMIT, MAP_Y_LIMIT);
+	open.fill();
+	for(unsigned int i = 0; i < open.words.size(); i++)
 	{
-		if(c == snake[i])
-			return true;
+		open.words[i] &= ~occupied.words[i];
 	}
-	return false;
+	open.set(snake.front().x, snake.front().y);
+	return open;
 }
 
 void state::operator=(const state& s)
 {
+	MAP_X_LIMIT = s.MAP_X_LIMIT;
+	MAP_Y_LIMIT = s.MAP_Y_LIMIT;
 	direction_modifier = s.direction_modifier;
 	food = s.food;
+	food_source = s.food_source;
+	occupied = s.occupied;
 	score = s.score;
 	loss = s.loss;
 
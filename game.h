@@ -5,12 +5,25 @@
  */
 
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
 #include <vector>
+#include "bitboard.h"
 using namespace std;
 
 #ifndef GAME_H_
 #define GAME_H_
 
+//Random numbers used by the game simulation and the search. Each thread has
+//its own generator so a game evaluated on any worker is reproducible from
+//the seed it was started with.
+int game_rand();
+void seed_game_rand(unsigned int seed);
+//Exchanges the calling thread's generator with engine, so a game played a
+//move at a time across threads can carry its generator between moves
+void swap_game_rand(minstd_rand& engine);
+
 //stores a coordinate pair in the Cartesian plane
 class coordinate
 {
@@ -22,15 +35,40 @@ class coordinate
 		bool operator==(const coordinate s){return x == s.x && y == s.y;}
 };
 
+//The food placements of one game, drawn from the game's own seed ahead of
+//when they are used. Entry n decides where the nth piece of food goes, so
+//the real game and every searched state that has eaten the same amount of
+//food place it identically without touching any shared random generator.
+class food_sequence
+{
+	public:
+		food_sequence(unsigned int seed);
+
+		//Returns entry n, extending the sequence if it has not been drawn yet.
+		//States of one game may be searched on several threads at once.
+		unsigned int at(int n);
+
+	private:
+		mutex lock;
+		minstd_rand engine;
+		vector<unsigned int> values;
+};
+
 //Stores the game map including the snake and food positions
 class state
 {
 	public:
 		//Size of the snake to start the game
 		const int START_SIZE = 5;
+		//The largest map limit supported in either direction
+		static const int MAX_MAP_LIMIT = 256;
+		//Map limits used by new games. They can be changed at runtime with
+		//set_map_size before any games are created.
+		static int map_x_setting;
+		static int map_y_setting;
 		//Map limits
-		const int MAP_X_LIMIT = 25;
-		const int MAP_Y_LIMIT = 15;
+		int MAP_X_LIMIT = map_x_setting;
+		int MAP_Y_LIMIT = map_y_setting;
 		//Determines if the game has ended
 		bool loss = false;
 		//Direction modifier is a unit vector determining the direction
@@ -38,18 +76,40 @@ class state
 		coordinate direction_modifier;
 		//The location of the food tile
 		coordinate food;
+		//The food placements of the game this state belongs to, indexed by
+		//the number of food pieces eaten so far
+		shared_ptr<food_sequence> food_source;
 		//A container with all the body segments of the snake
 		vector<coordinate> snake;
+		//The tiles covered by the snake, kept in step with the snake container
+		//so collision tests and food placement do not scan the body
+		bitboard occupied;
 		//Score and turn values stored over the course of the game
 		int score = 0;
 		int turn = 0;
 
-		state();
+		//A new game draws the seed of its food sequence from game_rand unless
+		//it is given the sequence to use
+		state(shared_ptr<food_sequence> source = nullptr);
+
+		//Sets the map limits of games created afterwards. Returns false and
+		//leaves the limits unchanged if the size is not supported.
+		static bool set_map_size(int map_x_limit, int map_y_limit);
+
 		//Functions used to determine possible actions and how the state reacts
 		//to those changes
 		void place_food();
+		//Places the food on the open tile picked by draw, the way place_food
+		//does with the game's food sequence entry
+		void place_food(unsigned int draw);
 		vector<coordinate> actions();
+		//Writes the same actions into a fixed array and returns how many there
+		//are, for searches that should not allocate at every node
+		static const int MAX_ACTIONS = 3;
+		int actions(coordinate (&possible_actions)[MAX_ACTIONS]);
 		state result(coordinate action);
+		//Returns true if result(action) would be a loss, without building it
+		bool loses(coordinate action);
 
 		//Prints the state to the standard output
 		void display();
@@ -58,6 +118,13 @@ class state
 		//body segment
 		bool in_snake(coordinate& c);
 
+		//Returns the tiles the snake can move through. The tail tile counts
+		//as open because it is vacated as the snake moves forward.
+		bitboard open_tiles();
+
+		//A copy carries every member over, including the turn counter, while
+		//assignment has never carried the turn counter
+		state(const state& s) = default;
 		void operator=(const state& s);
 };
 
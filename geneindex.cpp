@@ -0,0 +1,80 @@
+/*
+ * geneindex.cpp
+ * This file contains the function implementations for the gene index
+ */
+
+#include <cmath>
+#include "geneindex.h"
+using namespace std;
+
+//Walks down from the root to the empty branch where the point belongs
+int gene_index::add(const vector<float>& point, int value)
+{
+	int position = points.size();
+	points.push_back(point);
+	values.push_back(value);
+	left.push_back(-1);
+	right.push_back(-1);
+	split.push_back(0);
+	if(position == 0)
+		return position;
+
+	int node = 0;
+	int depth = 0;
+	while(true)
+	{
+		int dimension = split[node];
+		int& child = point[dimension] < points[node][dimension] ? left[node] : right[node];
+		depth++;
+		if(child == -1)
+		{
+			child = position;
+			split[position] = depth % point.size();
+			return position;
+		}
+		node = child;
+	}
+}
+
+int gene_index::nearest_within(const vector<float>& point, float epsilon)
+{
+	if(points.empty())
+		return -1;
+	float best_distance = epsilon * epsilon;
+	int best = -1;
+	search(0, point, best_distance, best);
+	return best;
+}
+
+int gene_index::size()
+{
+	return points.size();
+}
+
+//Searches the side of the split holding the point first, then the other
+//side only if the splitting plane is closer than the best match so far
+void gene_index::search(int node, const vector<float>& point, float& best_distance, int& best)
+{
+	if(node == -1)
+		return;
+
+	float distance = 0;
+	for(unsigned int i = 0; i < point.size(); i++)
+	{
+		float difference = point[i] - points[node][i];
+		distance += difference * difference;
+	}
+	if(distance <= best_distance)
+	{
+		best_distance = distance;
+		best = node;
+	}
+
+	int dimension = split[node];
+	float plane = point[dimension] - points[node][dimension];
+	int near = plane < 0 ? left[node] : right[node];
+	int far = plane < 0 ? right[node] : left[node];
+	search(near, point, best_distance, best);
+	if(plane * plane <= best_distance)
+		search(far, point, best_distance, best);
+}
@@ -0,0 +1,42 @@
+/*
+ * geneindex.h
+ * This file contains the header information for the gene index, a k-d tree
+ * used to find genomes with nearly the same genes
+ */
+
+#include <vector>
+using namespace std;
+
+#ifndef GENEINDEX_H_
+#define GENEINDEX_H_
+
+//A k-d tree over gene vectors. Each level of the tree splits on the next
+//gene, so a search only visits the branches that can hold a vector within
+//the search distance. Vectors are added as they are evaluated and never
+//removed; the genes of a population are spread enough by breeding that the
+//tree stays shallow without rebalancing.
+class gene_index
+{
+	public:
+		//The vectors in the order they were added, with a value stored for each
+		vector<vector<float>> points;
+		vector<int> values;
+
+		//Adds a vector and returns its position
+		int add(const vector<float>& point, int value);
+		//Finds the nearest vector within the Euclidean distance epsilon.
+		//Returns its position, or -1 if there is none.
+		int nearest_within(const vector<float>& point, float epsilon);
+
+		int size();
+
+	private:
+		//Node i holds point i
+		vector<int> left;
+		vector<int> right;
+		vector<int> split;
+
+		void search(int node, const vector<float>& point, float& best_distance, int& best);
+};
+
+#endif /* GENEINDEX_H_ */
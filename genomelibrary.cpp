@@ -0,0 +1,230 @@
+/*
+ * genomelibrary.cpp
+ * This file contains the function implementations for the genome library
+ */
+
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "genomelibrary.h"
+using namespace std;
+
+genome_library::~genome_library()
+{
+	close();
+}
+
+//Maps the whole file and checks that its header, records and index fit
+bool genome_library::open(const char* file_name)
+{
+	close();
+	int descriptor = ::open(file_name, O_RDONLY);
+	if(descriptor < 0)
+	{
+		cout << "Failed to open genome library " << file_name << endl;
+		return false;
+	}
+
+	struct stat file_status;
+	if(fstat(descriptor, &file_status) != 0 || file_status.st_size < (off_t)sizeof(genome_library_header))
+	{
+		::close(descriptor);
+		cout << "Failed to read genome library " << file_name << endl;
+		return false;
+	}
+	length = file_status.st_size;
+	void* mapping = mmap(nullptr, length, PROT_READ, MAP_SHARED, descriptor, 0);
+	::close(descriptor);
+	if(mapping == MAP_FAILED)
+	{
+		length = 0;
+		cout << "Failed to map genome library " << file_name << endl;
+		return false;
+	}
+	data = static_cast<const char*>(mapping);
+	header = reinterpret_cast<const genome_library_header*>(data);
+
+	genome_library_header expected;
+	uint64_t count = header->record_count;
+	bool valid = memcmp(header->magic, expected.magic, sizeof(expected.magic)) == 0
+			&& header->version == expected.version && header->record_size == expected.record_size
+			&& count <= (length - sizeof(genome_library_header)) / (sizeof(genome_record) + sizeof(uint64_t))
+			&& length == sizeof(genome_library_header) + count * (sizeof(genome_record) + sizeof(uint64_t));
+	if(!valid)
+	{
+		close();
+		cout << file_name << " is not a genome library" << endl;
+		return false;
+	}
+	records = reinterpret_cast<const genome_record*>(data + sizeof(genome_library_header));
+	index = reinterpret_cast<const uint64_t*>(records + count);
+
+	//A ranked lookup reads the record an index entry names, so every entry
+	//must name a record in the file
+	for(uint64_t i = 0; i < count; i++)
+	{
+		if(index[i] >= count)
+		{
+			close();
+			cout << file_name << " is not a genome library" << endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+void genome_library::close()
+{
+	if(data != nullptr)
+		munmap(const_cast<char*>(data), length);
+	data = nullptr;
+	length = 0;
+	header = nullptr;
+	records = nullptr;
+	index = nullptr;
+}
+
+uint64_t genome_library::size()
+{
+	return header == nullptr ? 0 : header->record_count;
+}
+
+const genome_record& genome_library::record(uint64_t i)
+{
+	return records[i];
+}
+
+const genome_record& genome_library::ranked(uint64_t rank)
+{
+	return records[index[rank]];
+}
+
+vector<genome> genome_library::best(uint64_t count)
+{
+	vector<genome> genomes;
+	for(uint64_t rank = 0; rank < min(count, size()); rank++)
+	{
+		genomes.push_back(to_genome(ranked(rank)));
+	}
+	return genomes;
+}
+
+bool genome_library::is_library(const char* file_name)
+{
+	genome_library_header expected;
+	char magic[sizeof(expected.magic)] = {};
+	ifstream file(file_name, ios::binary);
+	file.read(magic, sizeof(magic));
+	return file.good() && memcmp(magic, expected.magic, sizeof(magic)) == 0;
+}
+
+genome genome_library::to_genome(const genome_record& record)
+{
+	genome g;
+	g.id = record.id;
+	g.fitness_value = record.fitness_value;
+	g.parent_a_id = record.parent_a_id;
+	g.parent_b_id = record.parent_b_id;
+	g.generation_born = record.generation_born;
+	int count = min(record.gene_count, (int32_t)genome_record::MAX_GENES);
+	g.set_genes(vector<float>(record.genes, record.genes + max(count, 0)));
+	return g;
+}
+
+genome_record genome_library::to_record(genome& g, int turn_limit, unsigned int run_seed)
+{
+	genome_record record;
+	record.id = g.id;
+	record.fitness_value = g.fitness_value;
+	record.parent_a_id = g.parent_a_id;
+	record.parent_b_id = g.parent_b_id;
+	record.generation_born = g.generation_born;
+	record.turn_limit = turn_limit;
+	record.run_seed = run_seed;
+	record.map_x = state::map_x_setting;
+	record.map_y = state::map_y_setting;
+	record.archived_time = time(nullptr);
+
+	vector<float> values = g.genes();
+	record.gene_count = values.size();
+	copy(values.begin(), values.end(), record.genes);
+	return record;
+}
+
+//The file is written beside the old one and renamed over it, so a library
+//that is mapped elsewhere is never changed underneath its reader
+bool genome_library::write(const char* file_name, const vector<genome_record>& records)
+{
+	//Ties keep the order the genomes were added
+	vector<uint64_t> order(records.size());
+	for(uint64_t i = 0; i < order.size(); i++)
+	{
+		order[i] = i;
+	}
+	stable_sort(order.begin(), order.end(), [&](uint64_t a, uint64_t b)
+	{
+		return records[a].fitness_value > records[b].fitness_value;
+	});
+
+	genome_library_header header;
+	header.record_count = records.size();
+
+	string temporary_name = string(file_name) + ".tmp";
+	ofstream file(temporary_name, ios::binary | ios::trunc);
+	if(file.is_open())
+	{
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(genome_record));
+		file.write(reinterpret_cast<const char*>(order.data()), order.size() * sizeof(uint64_t));
+		file.close();
+		if(!file.fail() && rename(temporary_name.c_str(), file_name) == 0)
+			return true;
+		remove(temporary_name.c_str());
+	}
+	cout << "Failed to save genome library to " << file_name << endl;
+	return false;
+}
+
+bool genome_library::append(const char* file_name, const vector<genome_record>& records)
+{
+	vector<genome_record> all;
+	if(access(file_name, F_OK) == 0)
+	{
+		genome_library existing;
+		if(!existing.open(file_name))
+			return false;
+		all.assign(existing.records, existing.records + existing.size());
+	}
+	all.insert(all.end(), records.begin(), records.end());
+	return write(file_name, all);
+}
+
+int genome_library::import_text(const char* file_name, const vector<const char*>& text_files)
+{
+	vector<genome_record> imported;
+	for(unsigned int i = 0; i < text_files.size(); i++)
+	{
+		genome g;
+		if(g.load_from_file(text_files[i]))
+		{
+			//Text files do not record the run that produced them
+			genome_record record = to_record(g);
+			record.map_x = 0;
+			record.map_y = 0;
+			record.archived_time = 0;
+			imported.push_back(record);
+		}
+		else
+			cout << "Skipped " << text_files[i] << endl;
+	}
+	if(!imported.empty() && !append(file_name, imported))
+		return 0;
+	return imported.size();
+}
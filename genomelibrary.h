@@ -0,0 +1,104 @@
+/*
+ * genomelibrary.h
+ * This file contains the header information for the genome library, a
+ * binary file of many genomes which is memory mapped instead of parsed
+ */
+
+#include <cstdint>
+#include <vector>
+#include "evolutionaryframework.h"
+using namespace std;
+
+#ifndef GENOMELIBRARY_H_
+#define GENOMELIBRARY_H_
+
+//One genome in a library. Every record has the same size so any record can
+//be read in place at a fixed offset of the mapped file.
+class genome_record
+{
+	public:
+		//Room for genes added later without changing the record size
+		static const int MAX_GENES = 32;
+
+		int32_t id = 0;
+		int32_t fitness_value = 0;
+		//Lineage, with -1 for genomes without parents
+		int32_t parent_a_id = -1;
+		int32_t parent_b_id = -1;
+		int32_t generation_born = 0;
+
+		//The settings of the run that produced the genome, with zero when
+		//they are unknown
+		int32_t turn_limit = 0;
+		uint32_t run_seed = 0;
+		int32_t map_x = 0;
+		int32_t map_y = 0;
+		//Seconds since the epoch when the genome was archived
+		int64_t archived_time = 0;
+
+		//The genes in genome declaration order
+		int32_t gene_count = 0;
+		float genes[MAX_GENES] = {};
+};
+
+//The start of a library file. The records follow the header, then the
+//index, which lists the record numbers from the fittest genome down.
+class genome_library_header
+{
+	public:
+		char magic[8] = {'S', 'N', 'A', 'K', 'E', 'L', 'I', 'B'};
+		uint32_t version = 1;
+		uint32_t record_size = sizeof(genome_record);
+		uint64_t record_count = 0;
+};
+
+//A read only view of a library file. The file is mapped into memory, so
+//opening a library of millions of genomes costs nothing until records are
+//read, and scans only touch the pages they need.
+class genome_library
+{
+	public:
+		genome_library() {}
+		~genome_library();
+		genome_library(const genome_library&) = delete;
+		genome_library& operator=(const genome_library&) = delete;
+
+		//Maps a library file. Returns false if the file cannot be read or
+		//is not a library.
+		bool open(const char* file_name);
+		void close();
+
+		//The number of genomes in the library
+		uint64_t size();
+		//Record i in the order the genomes were added
+		const genome_record& record(uint64_t i);
+		//The genome with the given fitness rank, where rank 0 is the fittest
+		const genome_record& ranked(uint64_t rank);
+		//The fittest genomes, up to count of them
+		vector<genome> best(uint64_t count);
+
+		//Returns true if the file starts with the library header
+		static bool is_library(const char* file_name);
+
+		//Converts between records and genomes
+		static genome to_genome(const genome_record& record);
+		static genome_record to_record(genome& g, int turn_limit = 0, unsigned int run_seed = 0);
+
+		//Writes a library holding the given records, replacing the file
+		static bool write(const char* file_name, const vector<genome_record>& records);
+		//Adds records to a library, creating it if it does not exist. The
+		//index is rebuilt, so the existing records are copied once.
+		static bool append(const char* file_name, const vector<genome_record>& records);
+		//Reads text genome files into records and appends them to a library.
+		//Returns the number of files imported.
+		static int import_text(const char* file_name, const vector<const char*>& text_files);
+
+	private:
+		const char* data = nullptr;
+		size_t length = 0;
+		const genome_library_header* header = nullptr;
+		const genome_record* records = nullptr;
+		const uint64_t* index = nullptr;
+};
+
+#endif /* GENOMELIBRARY_H_ */
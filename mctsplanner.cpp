@@ -0,0 +1,288 @@
+/*
+ * mctsplanner.cpp
+ * This file contains the function implementations for the Monte Carlo tree
+ * search planner
+ */
+
+#include <cmath>
+#include <climits>
+#include "mctsplanner.h"
+using namespace std;
+
+mcts_planner::mcts_planner(int simulations, int rollout_depth, int food_samples, unsigned int seed)
+{
+	SIMULATIONS = simulations;
+	ROLLOUT_DEPTH = rollout_depth;
+	FOOD_SAMPLES = food_samples;
+	engine.seed(seed);
+	//A simulation adds at most the children of one decision node and the
+	//placements of one chance node
+	capacity = 2 * SIMULATIONS * (state::MAX_ACTIONS + FOOD_SAMPLES) + 1;
+	nodes.reserve(capacity);
+	spare.reserve(capacity);
+	nodes.push_back(mcts_node());
+}
+
+coordinate mcts_planner::choose(genome& player, state& s)
+{
+	heuristic_plan plan = player.plan_heuristic(s);
+	reuse_tree(s);
+	for(int i = 0; i < SIMULATIONS; i++)
+	{
+		simulate(player, s, plan);
+	}
+
+	mcts_node& root = nodes[0];
+	if(root.child_count == 0)
+		return s.direction_modifier;
+
+	//Take the most simulated action, then the one with the higher mean value,
+	//selecting randomly if there is still a tie
+	vector<int> best_child;
+	for(int i = root.first_child; i < root.first_child + root.child_count; i++)
+	{
+		if(best_child.empty())
+		{
+			best_child.push_back(i);
+			continue;
+		}
+		mcts_node& best = nodes[best_child[0]];
+		mcts_node& child = nodes[i];
+		double best_mean = best.visits > 0 ? best.value_sum / best.visits : 0;
+		double child_mean = child.visits > 0 ? child.value_sum / child.visits : 0;
+		if(child.visits == best.visits && child_mean == best_mean)
+			best_child.push_back(i);
+		else if(child.visits > best.visits || (child.visits == best.visits && child_mean > best_mean))
+		{
+			best_child.clear();
+			best_child.push_back(i);
+		}
+	}
+	chosen_child = best_child[engine() % best_child.size()];
+
+	coordinate action = nodes[chosen_child].action;
+	state next = s.result(action);
+	expected_snake = next.snake;
+	expected_food = s.food;
+	return action;
+}
+
+//Keeps the subtree of the state the game reached, if the last move's tree
+//holds it, by copying it to the front of the spare arena. The spare arena
+//doubles as the queue of nodes whose children are still to be copied, so
+//every node's children stay together.
+void mcts_planner::reuse_tree(state& s)
+{
+	int kept = -1;
+	bool same_snake = chosen_child >= 0 && s.snake.size() == expected_snake.size();
+	for(unsigned int i = 0; same_snake && i < s.snake.size(); i++)
+	{
+		same_snake = s.snake[i].x == expected_snake[i].x && s.snake[i].y == expected_snake[i].y;
+	}
+	if(same_snake)
+	{
+		mcts_node& child = nodes[chosen_child];
+		if(!child.chance && s.food == expected_food)
+			kept = chosen_child;
+		for(int i = child.first_child; child.chance && i < child.first_child + child.child_count; i++)
+		{
+			if(s.food == nodes[i].food)
+			{
+				kept = i;
+				break;
+			}
+		}
+	}
+	chosen_child = -1;
+
+	spare.clear();
+	spare.push_back(kept >= 0 ? nodes[kept] : mcts_node());
+	for(unsigned int i = 0; i < spare.size(); i++)
+	{
+		int first_child = spare[i].first_child;
+		int child_count = spare[i].child_count;
+		if(child_count == 0)
+			continue;
+		spare[i].first_child = spare.size();
+		for(int j = 0; j < child_count; j++)
+		{
+			spare.push_back(nodes[first_child + j]);
+		}
+	}
+	nodes.swap(spare);
+}
+
+//Descends from the root to a node that has not been expanded, expanding the
+//root and any node visited before, then rolls out from there and adds the
+//value to every node passed
+void mcts_planner::simulate(genome& player, state& root, const heuristic_plan& plan)
+{
+	state current(root);
+	int node = 0;
+	path.clear();
+	path.push_back(node);
+	while(!current.loss)
+	{
+		if(nodes[node].chance)
+		{
+			//Each sampled placement is visited in turn, so they are weighted
+			//equally. Without room for them the food is placed at random.
+			if(nodes[node].child_count == 0 && !expand_chance(node, current))
+			{
+				current.place_food(engine());
+				break;
+			}
+			node = nodes[node].first_child + nodes[node].visits % nodes[node].child_count;
+			current.food = nodes[node].food;
+			path.push_back(node);
+			continue;
+		}
+		if(nodes[node].child_count == 0 && ((node != 0 && nodes[node].visits == 0) || !expand(node, current)))
+			break;
+		node = select_child(node);
+		//Assignment does not carry the turn counter, which is one in every
+		//searched state
+		current = current.result(nodes[node].action);
+		current.turn = 1;
+		path.push_back(node);
+	}
+
+	int value = rollout(player, current, plan);
+	for(unsigned int i = 0; i < path.size(); i++)
+	{
+		nodes[path[i]].visits++;
+		nodes[path[i]].value_sum += value;
+	}
+}
+
+//Adds a child for each action of a decision node. Actions that lose at once
+//are left out unless every action does, since their loss penalty would
+//swamp the mean value of the node. Actions onto the food lead to chance
+//nodes.
+bool mcts_planner::expand(int node, state& s)
+{
+	coordinate all_actions[state::MAX_ACTIONS];
+	coordinate actions[state::MAX_ACTIONS];
+	int all_count = s.actions(all_actions);
+	int count = 0;
+	for(int i = 0; i < all_count; i++)
+	{
+		if(!s.loses(all_actions[i]))
+			actions[count++] = all_actions[i];
+	}
+	if(count == 0)
+	{
+		for(int i = 0; i < all_count; i++)
+		{
+			actions[i] = all_actions[i];
+		}
+		count = all_count;
+	}
+	if(count == 0 || (int)nodes.size() + count > capacity)
+		return false;
+	nodes[node].first_child = nodes.size();
+	nodes[node].child_count = count;
+	for(int i = 0; i < count; i++)
+	{
+		mcts_node child;
+		child.action = actions[i];
+		child.chance = s.food == coordinate(s.snake.back().x + actions[i].x, s.snake.back().y + actions[i].y);
+		nodes.push_back(child);
+	}
+	return true;
+}
+
+//Samples FOOD_SAMPLES placements for the state that has just eaten
+bool mcts_planner::expand_chance(int node, state& s)
+{
+	if((int)nodes.size() + FOOD_SAMPLES > capacity)
+		return false;
+	nodes[node].first_child = nodes.size();
+	nodes[node].child_count = FOOD_SAMPLES;
+	for(int i = 0; i < FOOD_SAMPLES; i++)
+	{
+		s.place_food(engine());
+		mcts_node outcome;
+		outcome.food = s.food;
+		nodes.push_back(outcome);
+	}
+	return true;
+}
+
+//Upper confidence bound for trees. Children that have never been simulated
+//are tried first, in action order. The mean values are scaled between the
+//lowest and highest mean of the siblings, since a loss penalty far below
+//every other value would otherwise leave the rest indistinguishable.
+int mcts_planner::select_child(int node)
+{
+	mcts_node& parent = nodes[node];
+	double lowest = 0;
+	double highest = 0;
+	for(int i = parent.first_child; i < parent.first_child + parent.child_count; i++)
+	{
+		mcts_node& child = nodes[i];
+		if(child.visits == 0)
+			return i;
+		double mean = child.value_sum / child.visits;
+		if(i == parent.first_child || mean < lowest)
+			lowest = mean;
+		if(i == parent.first_child || mean > highest)
+			highest = mean;
+	}
+
+	double exploration = EXPLORATION * sqrt(log(max(parent.visits, 1)));
+	double range = highest - lowest;
+	int best = -1;
+	double best_bound = 0;
+	for(int i = parent.first_child; i < parent.first_child + parent.child_count; i++)
+	{
+		mcts_node& child = nodes[i];
+		double mean = child.value_sum / child.visits;
+		double bound = (range > 0 ? (mean - lowest) / range : 0.5) + exploration / sqrt(child.visits);
+		if(best < 0 || bound > best_bound)
+		{
+			best = i;
+			best_bound = bound;
+		}
+	}
+	return best;
+}
+
+//Plays ROLLOUT_DEPTH moves, each to the child with the highest heuristic
+//value with ties broken randomly, and returns the value of the last state
+int mcts_planner::rollout(genome& player, state& s, const heuristic_plan& plan)
+{
+	if(s.loss || ROLLOUT_DEPTH == 0)
+		return player.planned_heuristic(s, plan);
+	int value = INT_MIN;
+	state chosen(s);
+	for(int step = 0; step < ROLLOUT_DEPTH && !s.loss; step++)
+	{
+		coordinate actions[state::MAX_ACTIONS];
+		int count = s.actions(actions);
+		int best = INT_MIN;
+		int ties = 0;
+		for(int i = 0; i < count; i++)
+		{
+			state child = s.result(actions[i]);
+			if(child.score > s.score)
+				child.place_food(engine());
+			//A child below the best so far only needs to be known to be below it
+			int child_value = player.planned_heuristic(child, plan, best);
+			if(ties == 0 || child_value > best)
+			{
+				best = child_value;
+				ties = 1;
+				chosen = child;
+			}
+			else if(child_value == best && engine() % ++ties == 0)
+				chosen = child;
+		}
+		if(ties == 0)
+			return step == 0 ? player.planned_heuristic(s, plan) : value;
+		s = chosen;
+		s.turn = 1;
+		value = best;
+	}
+	return value;
+}
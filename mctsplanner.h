@@ -0,0 +1,96 @@
+/*
+ * mctsplanner.h
+ * This file contains the header information for the Monte Carlo tree search
+ * planner, which chooses a genome's moves from a budget of simulated games
+ */
+
+#include <random>
+#include <vector>
+#include "evolutionaryframework.h"
+#include "game.h"
+using namespace std;
+
+#ifndef MCTSPLANNER_H_
+#define MCTSPLANNER_H_
+
+//A node of the search tree. A decision node's children are the states after
+//each of its actions. Taking an action onto the food leads to a chance node
+//instead, whose children are the same state with different sampled food
+//placements. Nodes are plain records kept in one arena and refer to each
+//other by position, so the tree never allocates while it is searched.
+class mcts_node
+{
+	public:
+		//The position of the first child in the arena, where the children
+		//of a node are stored together, and how many there are
+		int first_child = -1;
+		int child_count = 0;
+		//The action taken from the parent decision node, or for a child of
+		//a chance node the food placement it samples
+		coordinate action;
+		coordinate food;
+		bool chance = false;
+		//The number of simulations through the node and the sum of their
+		//heuristic values
+		int visits = 0;
+		double value_sum = 0;
+};
+
+//Chooses moves by running SIMULATIONS simulated games from the current
+//state. Each simulation descends the tree by UCT, adds the children of the
+//first node reached for the second time, then plays ROLLOUT_DEPTH further
+//moves choosing the child the genome's heuristic rates highest, and adds
+//the heuristic value of where it ended to every node it passed. The action
+//with the most simulations is taken.
+//Food eaten in the tree is placed at one of FOOD_SAMPLES placements sampled
+//when its chance node is added, visited in turn, and food eaten during a
+//rollout is placed at random. The search never sees the game's own food
+//sequence past the food already on the map.
+//After each move the subtree below the chosen action, and below the food
+//placement the game actually made when it matches a sample, becomes the
+//next move's tree.
+class mcts_planner
+{
+	public:
+		//The UCT exploration constant, for values scaled between 0 and 1
+		static constexpr double EXPLORATION = 1.4;
+
+		int SIMULATIONS;
+		int ROLLOUT_DEPTH;
+		int FOOD_SAMPLES;
+
+		//The arena is sized for one move's simulations on top of a kept
+		//subtree as large as a whole move's tree. Once it is full the
+		//simulations roll out from the leaves without growing the tree. Its
+		//random numbers come from seed, so a game played with the planner
+		//is reproducible.
+		mcts_planner(int simulations, int rollout_depth, int food_samples, unsigned int seed);
+
+		//Runs the simulations from s and returns the action to take
+		coordinate choose(genome& player, state& s);
+
+		//The tree, with the root first, and the arena the kept subtree is
+		//copied into between moves
+		vector<mcts_node> nodes;
+		vector<mcts_node> spare;
+
+	private:
+		minstd_rand engine;
+		int capacity;
+		//The nodes passed by the current simulation
+		vector<int> path;
+
+		//The root child chosen by the last move and the snake it leads to
+		int chosen_child = -1;
+		vector<coordinate> expected_snake;
+		coordinate expected_food;
+
+		void reuse_tree(state& s);
+		void simulate(genome& player, state& root, const heuristic_plan& plan);
+		bool expand(int node, state& s);
+		bool expand_chance(int node, state& s);
+		int select_child(int node);
+		int rollout(genome& player, state& s, const heuristic_plan& plan);
+};
+
+#endif /* MCTSPLANNER_H_ */
@@ -0,0 +1,239 @@
+/*
+ * optimizer.cpp
+ * This file contains the function implementations for the optimizers
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include "optimizer.h"
+using namespace std;
+
+//The usual settings for the learning rates, from the number of genes and
+//the recombination weights
+cma_es::cma_es(int new_dimension, int new_population, double new_initial_sigma)
+{
+	dimension = new_dimension;
+	population = new_population;
+	parents = population / 2;
+	initial_sigma = new_initial_sigma;
+	mean.assign(dimension, 0);
+
+	double weight_total = 0;
+	for(int i = 0; i < parents; i++)
+	{
+		weights.push_back(log(parents + 0.5) - log(i + 1.0));
+		weight_total += weights[i];
+	}
+	double square_total = 0;
+	for(int i = 0; i < parents; i++)
+	{
+		weights[i] /= weight_total;
+		square_total += weights[i] * weights[i];
+	}
+	mueff = 1 / square_total;
+
+	double n = dimension;
+	cc = (4 + mueff / n) / (n + 4 + 2 * mueff / n);
+	cs = (mueff + 2) / (n + mueff + 5);
+	c1 = 2 / ((n + 1.3) * (n + 1.3) + mueff);
+	cmu = min(1 - c1, 2 * (mueff - 2 + 1 / mueff) / ((n + 2) * (n + 2) + mueff));
+	damps = 1 + 2 * max(0.0, sqrt((mueff - 1) / (n + 1)) - 1) + cs;
+	chi_n = sqrt(n) * (1 - 1 / (4 * n) + 1 / (21 * n * n));
+	restart();
+}
+
+void cma_es::restart()
+{
+	sigma = initial_sigma;
+	covariance.assign(dimension, vector<double>(dimension, 0));
+	basis.assign(dimension, vector<double>(dimension, 0));
+	for(int i = 0; i < dimension; i++)
+	{
+		covariance[i][i] = 1;
+		basis[i][i] = 1;
+	}
+	scale.assign(dimension, 1);
+	path_c.assign(dimension, 0);
+	path_sigma.assign(dimension, 0);
+	updates = 0;
+}
+
+//The genes are mean + sigma * B D z for a standard normal z
+vector<float> cma_es::ask(minstd_rand& engine)
+{
+	normal_distribution<double> normal(0, 1);
+	vector<double> z(dimension);
+	for(int i = 0; i < dimension; i++)
+	{
+		z[i] = scale[i] * normal(engine);
+	}
+	vector<float> genes(dimension);
+	for(int i = 0; i < dimension; i++)
+	{
+		double step = 0;
+		for(int j = 0; j < dimension; j++)
+		{
+			step += basis[i][j] * z[j];
+		}
+		genes[i] = mean[i] + sigma * step;
+	}
+	return genes;
+}
+
+void cma_es::tell(vector<genome>& ranked)
+{
+	//The steps of the fittest genomes from the old mean, fittest first
+	vector<vector<double>> steps;
+	for(int i = 0; i < parents && i < (int)ranked.size(); i++)
+	{
+		vector<float> genes = ranked[ranked.size() - 1 - i].genes();
+		vector<double> step(dimension);
+		for(int j = 0; j < dimension; j++)
+		{
+			step[j] = (genes[j] - mean[j]) / sigma;
+		}
+		steps.push_back(step);
+	}
+
+	vector<double> mean_step(dimension, 0);
+	for(unsigned int i = 0; i < steps.size(); i++)
+	{
+		for(int j = 0; j < dimension; j++)
+		{
+			mean_step[j] += weights[i] * steps[i][j];
+		}
+	}
+	for(int j = 0; j < dimension; j++)
+	{
+		mean[j] += sigma * mean_step[j];
+	}
+
+	//The step size path is kept in the whitened space, C^-1/2 = B D^-1 B'
+	vector<double> whitened(dimension, 0);
+	for(int i = 0; i < dimension; i++)
+	{
+		double projection = 0;
+		for(int j = 0; j < dimension; j++)
+		{
+			projection += basis[j][i] * mean_step[j];
+		}
+		projection /= scale[i];
+		for(int j = 0; j < dimension; j++)
+		{
+			whitened[j] += basis[j][i] * projection;
+		}
+	}
+	double path_norm = 0;
+	for(int i = 0; i < dimension; i++)
+	{
+		path_sigma[i] = (1 - cs) * path_sigma[i] + sqrt(cs * (2 - cs) * mueff) * whitened[i];
+		path_norm += path_sigma[i] * path_sigma[i];
+	}
+	path_norm = sqrt(path_norm);
+	updates++;
+
+	//The covariance path stalls while the step size path is long, so a
+	//quickly growing step size does not also stretch the covariance
+	bool stalled = path_norm / sqrt(1 - pow(1 - cs, 2 * updates)) / chi_n >= 1.4 + 2 / (dimension + 1.0);
+	double h_sigma = stalled ? 0 : 1;
+	for(int i = 0; i < dimension; i++)
+	{
+		path_c[i] = (1 - cc) * path_c[i] + h_sigma * sqrt(cc * (2 - cc) * mueff) * mean_step[i];
+	}
+
+	for(int i = 0; i < dimension; i++)
+	{
+		for(int j = 0; j <= i; j++)
+		{
+			double rank_mu = 0;
+			for(unsigned int k = 0; k < steps.size(); k++)
+			{
+				rank_mu += weights[k] * steps[k][i] * steps[k][j];
+			}
+			double value = (1 - c1 - cmu) * covariance[i][j]
+					+ c1 * (path_c[i] * path_c[j] + (1 - h_sigma) * cc * (2 - cc) * covariance[i][j])
+					+ cmu * rank_mu;
+			covariance[i][j] = value;
+			covariance[j][i] = value;
+		}
+	}
+
+	sigma *= exp((cs / damps) * (path_norm / chi_n - 1));
+	decompose();
+}
+
+void cma_es::display()
+{
+	cout << "CMA-ES Step Size: " << sigma << " Axis Ratio: "
+		 << *max_element(scale.begin(), scale.end()) / *min_element(scale.begin(), scale.end()) << endl;
+}
+
+//Cyclic Jacobi rotations, which are plenty for a dozen genes. The scale
+//holds the square roots of the eigenvalues.
+void cma_es::decompose()
+{
+	vector<vector<double>> a = covariance;
+	for(int i = 0; i < dimension; i++)
+	{
+		for(int j = 0; j < dimension; j++)
+		{
+			basis[i][j] = i == j ? 1 : 0;
+		}
+	}
+
+	const int SWEEP_LIMIT = 50;
+	for(int sweep = 0; sweep < SWEEP_LIMIT; sweep++)
+	{
+		double off_diagonal = 0;
+		for(int p = 0; p < dimension; p++)
+		{
+			for(int q = p + 1; q < dimension; q++)
+			{
+				off_diagonal += a[p][q] * a[p][q];
+			}
+		}
+		if(off_diagonal < 1e-20)
+			break;
+
+		for(int p = 0; p < dimension; p++)
+		{
+			for(int q = p + 1; q < dimension; q++)
+			{
+				if(fabs(a[p][q]) < 1e-30)
+					continue;
+				double theta = (a[q][q] - a[p][p]) / (2 * a[p][q]);
+				double t = (theta >= 0 ? 1 : -1) / (fabs(theta) + sqrt(theta * theta + 1));
+				double c = 1 / sqrt(t * t + 1);
+				double s = t * c;
+				for(int k = 0; k < dimension; k++)
+				{
+					double akp = a[k][p];
+					double akq = a[k][q];
+					a[k][p] = c * akp - s * akq;
+					a[k][q] = s * akp + c * akq;
+				}
+				for(int k = 0; k < dimension; k++)
+				{
+					double apk = a[p][k];
+					double aqk = a[q][k];
+					a[p][k] = c * apk - s * aqk;
+					a[q][k] = s * apk + c * aqk;
+				}
+				for(int k = 0; k < dimension; k++)
+				{
+					double bkp = basis[k][p];
+					double bkq = basis[k][q];
+					basis[k][p] = c * bkp - s * bkq;
+					basis[k][q] = s * bkp + c * bkq;
+				}
+			}
+		}
+	}
+
+	//Rounding can leave tiny negative eigenvalues
+	for(int i = 0; i < dimension; i++)
+	{
+		scale[i] = sqrt(max(a[i][i], 1e-20));
+	}
+}
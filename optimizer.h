@@ -0,0 +1,82 @@
+/*
+ * optimizer.h
+ * This file contains the header information for the optimizers that can
+ * breed an evolution's generations in place of its genetic algorithm
+ */
+
+#include <random>
+#include <vector>
+#include "evolutionaryframework.h"
+using namespace std;
+
+#ifndef OPTIMIZER_H_
+#define OPTIMIZER_H_
+
+//The optimizers an evolution can use. The genetic algorithm is the
+//evolution's own selection, crossover and mutation.
+enum optimizer_type {OPTIMIZER_GENETIC, OPTIMIZER_CMA_ES, OPTIMIZER_COUNT};
+
+//An optimizer learns from each tested generation and proposes the genes of
+//the next one. The evolution still plays every fitness game, so screening,
+//deduplication, worker processes and the batch simulation work the same
+//with any optimizer.
+class optimizer
+{
+	public:
+		virtual ~optimizer() {}
+
+		//Learns from a tested generation sorted from least to most fit
+		virtual void tell(vector<genome>& ranked) = 0;
+		//Returns the genes of a new genome to test
+		virtual vector<float> ask(minstd_rand& engine) = 0;
+		//A one line description of the optimizer's state
+		virtual void display() = 0;
+		//Widens the search again after progress has stalled
+		virtual void restart() = 0;
+};
+
+//Covariance matrix adaptation evolution strategy. Genes are drawn from a
+//multivariate normal distribution whose mean moves towards the fitter half
+//of each generation, whose covariance learns the directions those genomes
+//lie in, and whose step size grows or shrinks with how far the mean
+//travels. Only the ranks of the fitness values are used.
+class cma_es : public optimizer
+{
+	public:
+		//The number of genes and genomes per generation, and the step size
+		//of the first generation drawn from the distribution
+		cma_es(int dimension, int population, double initial_sigma = 0.3);
+
+		void tell(vector<genome>& ranked);
+		vector<float> ask(minstd_rand& engine);
+		void display();
+		//Keeps the mean but returns the step size, covariance and paths to
+		//those of the first generation
+		void restart();
+
+		int dimension;
+		int population;
+		int parents;
+		double sigma;
+		double initial_sigma;
+		vector<double> mean;
+		vector<double> weights;
+		double mueff;
+
+		//The covariance and its eigen decomposition, C = B D^2 B'
+		vector<vector<double>> covariance;
+		vector<vector<double>> basis;
+		vector<double> scale;
+
+		//The evolution paths of the covariance and of the step size
+		vector<double> path_c;
+		vector<double> path_sigma;
+		int updates = 0;
+
+	private:
+		double cc, cs, c1, cmu, damps, chi_n;
+
+		void decompose();
+};
+
+#endif /* OPTIMIZER_H_ */
@@ -0,0 +1,84 @@
+/*
+ * optimizerbenchmark.cpp
+ * This file contains the function implementations for the optimizer
+ * benchmark
+ */
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include "evolutionaryframework.h"
+#include "optimizer.h"
+#include "optimizerbenchmark.h"
+using namespace std;
+
+void optimizer_benchmark::run()
+{
+	const char* NAMES[OPTIMIZER_COUNT] = {"genetic", "cma-es"};
+	shared_ptr<scheduler> pool = make_shared<scheduler>(base.THREADS);
+	runs.clear();
+	for(int r = 0; r < RUNS; r++)
+	{
+		for(int o = 0; o < OPTIMIZER_COUNT; o++)
+		{
+			run_config config = base;
+			config.OPTIMIZER = o;
+			config.SEED = base.SEED + r;
+			evolution run_e(config, pool);
+			run_e.verbose = false;
+			run_e.run();
+
+			optimizer_benchmark_run result;
+			result.optimizer = o;
+			result.seed = config.SEED;
+			result.best_fitness = run_e.generation.back().fitness_value;
+			result.reached = result.best_fitness >= base.TARGET_FITNESS;
+			result.generations = run_e.generation_number + 1;
+			result.games = run_e.games_played;
+			runs.push_back(result);
+			cout << "Seed " << result.seed << " " << NAMES[o] << ": " << result.games << " games, "
+				 << (result.reached ? "reached " : "best ") << result.best_fitness << endl;
+		}
+	}
+	display();
+}
+
+//Prints one row per optimizer. Runs that miss the target count as the games
+//they played, so the mean and median understate their true cost.
+void optimizer_benchmark::display()
+{
+	const char* NAMES[OPTIMIZER_COUNT] = {"genetic", "cma-es"};
+	cout << "Games to reach fitness " << base.TARGET_FITNESS << " in at most "
+		 << base.GENERATION_LIMIT + 1 << " generations of " << base.POPULATION_SIZE << endl;
+	cout << left << setw(11) << "Optimizer" << setw(9) << "Reached" << setw(14) << "Median Games"
+		 << setw(12) << "Mean Games" << setw(12) << "Most Games" << "Mean Best Fitness" << endl;
+	for(int o = 0; o < OPTIMIZER_COUNT; o++)
+	{
+		vector<long long> games;
+		int reached = 0;
+		double best_total = 0;
+		for(unsigned int i = 0; i < runs.size(); i++)
+		{
+			if(runs[i].optimizer != o)
+				continue;
+			games.push_back(runs[i].games);
+			reached += runs[i].reached;
+			best_total += runs[i].best_fitness;
+		}
+		if(games.empty())
+			continue;
+		sort(games.begin(), games.end());
+		double mean = 0;
+		for(unsigned int i = 0; i < games.size(); i++)
+		{
+			mean += games[i];
+		}
+		mean /= games.size();
+		cout << setw(11) << NAMES[o] << setw(9) << to_string(reached) + "/" + to_string(games.size())
+			 << setw(14) << games[games.size() / 2] << fixed << setprecision(0) << setw(12) << mean
+			 << setw(12) << games.back() << best_total / games.size() << endl;
+		cout.unsetf(ios::fixed);
+	}
+	cout << right;
+}
@@ -0,0 +1,43 @@
+/*
+ * optimizerbenchmark.h
+ * This file contains the header information for the optimizer benchmark
+ * which compares how many games each optimizer needs to reach a fitness
+ */
+
+#include <vector>
+#include "runconfig.h"
+using namespace std;
+
+#ifndef OPTIMIZERBENCHMARK_H_
+#define OPTIMIZERBENCHMARK_H_
+
+//One evolution of the benchmark
+class optimizer_benchmark_run
+{
+	public:
+		int optimizer = 0;
+		unsigned int seed = 0;
+		bool reached = false;
+		int generations = 0;
+		long long games = 0;
+		int best_fitness = 0;
+};
+
+//Evolves RUNS differently seeded runs with each optimizer until the fittest
+//genome of a generation reaches TARGET_FITNESS or GENERATION_LIMIT runs out,
+//and reports the fitness games each run played. Runs of both optimizers with
+//the same seed start from the same first generation and play the same
+//game seeds, so only the breeding differs.
+class optimizer_benchmark
+{
+	public:
+		run_config base;
+		int RUNS = 5;
+
+		vector<optimizer_benchmark_run> runs;
+
+		void run();
+		void display();
+};
+
+#endif /* OPTIMIZERBENCHMARK_H_ */
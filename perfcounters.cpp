@@ -0,0 +1,220 @@
+/*
+ * perfcounters.cpp
+ * This file contains the function implementations for the phase profiler
+ * and the allocation counter
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "perfcounters.h"
+using namespace std;
+
+//Every allocation through operator new is counted on the thread making it.
+//The count is a plain thread local, so it costs next to nothing when no
+//profiler is reading it.
+static thread_local long long thread_allocations = 0;
+
+void* operator new(size_t size)
+{
+	thread_allocations++;
+	if(size == 0)
+		size = 1;
+	while(true)
+	{
+		void* memory = malloc(size);
+		if(memory != nullptr)
+			return memory;
+		new_handler handler = get_new_handler();
+		if(handler == nullptr)
+			throw bad_alloc();
+		handler();
+	}
+}
+
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	free(memory);
+}
+
+//The hardware counters every thread so far has opened, one bit per counter,
+//and the error of the first counter that could not be opened
+static atomic<int> opened_counters(-1);
+static atomic<int> open_error(0);
+
+//A thread's hardware counters, opened as one group so they are read
+//together with a single system call
+class thread_counters
+{
+	public:
+		int descriptors[HARDWARE_COUNTERS];
+		//The position of each counter in a group read, or -1 when it is not open
+		int position[HARDWARE_COUNTERS];
+		int open_count = 0;
+
+		thread_counters()
+		{
+			const unsigned long long CONFIGS[HARDWARE_COUNTERS] = {PERF_COUNT_HW_CPU_CYCLES,
+					PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+			int leader = -1;
+			int opened = 0;
+			for(int i = 0; i < HARDWARE_COUNTERS; i++)
+			{
+				perf_event_attr attributes;
+				memset(&attributes, 0, sizeof(attributes));
+				attributes.size = sizeof(attributes);
+				attributes.type = PERF_TYPE_HARDWARE;
+				attributes.config = CONFIGS[i];
+				attributes.exclude_kernel = 1;
+				attributes.exclude_hv = 1;
+				attributes.read_format = PERF_FORMAT_GROUP;
+				descriptors[i] = syscall(SYS_perf_event_open, &attributes, 0, -1, leader, 0);
+				position[i] = -1;
+				if(descriptors[i] < 0)
+				{
+					int expected = 0;
+					open_error.compare_exchange_strong(expected, errno);
+					continue;
+				}
+				if(leader < 0)
+					leader = descriptors[i];
+				position[i] = open_count++;
+				opened |= 1 << i;
+			}
+			opened_counters &= opened;
+		}
+
+		~thread_counters()
+		{
+			for(int i = HARDWARE_COUNTERS - 1; i >= 0; i--)
+			{
+				if(descriptors[i] >= 0)
+					close(descriptors[i]);
+			}
+		}
+
+		//Reads the group through its leader, which is the first open counter
+		void read_into(long long* values)
+		{
+			if(open_count == 0)
+				return;
+			unsigned long long group[1 + HARDWARE_COUNTERS];
+			int leader = 0;
+			while(descriptors[leader] < 0)
+				leader++;
+			if(read(descriptors[leader], group, sizeof(group)) <= 0)
+				return;
+			for(int i = 0; i < HARDWARE_COUNTERS; i++)
+			{
+				if(position[i] >= 0)
+					values[i] = group[1 + position[i]];
+			}
+		}
+};
+
+counter_reading counter_reading::now()
+{
+	static thread_local thread_counters counters;
+	counter_reading reading;
+	counters.read_into(reading.values);
+	reading.values[COUNTER_ALLOCATIONS] = thread_allocations;
+	reading.values[COUNTER_NANOSECONDS] = chrono::duration_cast<chrono::nanoseconds>(
+			chrono::steady_clock::now().time_since_epoch()).count();
+	return reading;
+}
+
+phase_profiler::phase_profiler()
+{
+	for(int i = 0; i < PHASE_COUNT; i++)
+	{
+		for(int j = 0; j < COUNTER_COUNT; j++)
+		{
+			totals[i][j] = 0;
+		}
+	}
+}
+
+void phase_profiler::add(profile_phase phase, const counter_reading& start, const counter_reading& end)
+{
+	for(int i = 0; i < COUNTER_COUNT; i++)
+	{
+		totals[phase][i].fetch_add(end.values[i] - start.values[i], memory_order_relaxed);
+	}
+	totals[phase][COUNTER_CALLS].fetch_add(1, memory_order_relaxed);
+}
+
+//Prints one row per phase. The seconds are summed over the threads that
+//ran the phase, so they can exceed the time the generation took.
+void phase_profiler::display()
+{
+	const char* PHASE_NAMES[PHASE_COUNT] = {"fitness_test", "optimize_action", "spawn_generation"};
+	int opened = opened_counters;
+	int error = open_error;
+	//No thread has read the counters when every game is played in worker
+	//processes
+	if(opened == -1)
+		cout << "Hardware counters not read, no in-process games were measured" << endl;
+	else if(opened == 0 && error != 0)
+		cout << "Hardware counters unavailable (" << strerror(error) << "), showing time and allocations only" << endl;
+	else if(opened == 0)
+		cout << "Hardware counters unavailable, showing time and allocations only" << endl;
+
+	cout << left << setw(18) << "Phase" << setw(10) << "Calls" << setw(10) << "Seconds"
+		 << setw(15) << "Cycles" << setw(15) << "Instructions" << setw(6) << "IPC"
+		 << setw(14) << "Cache misses" << setw(15) << "Branch misses" << "Allocations" << endl;
+	for(int i = 0; i < PHASE_COUNT; i++)
+	{
+		long long values[COUNTER_COUNT];
+		for(int j = 0; j < COUNTER_COUNT; j++)
+		{
+			values[j] = totals[i][j].exchange(0, memory_order_relaxed);
+		}
+		cout << setw(18) << PHASE_NAMES[i] << setw(10) << values[COUNTER_CALLS]
+			 << fixed << setprecision(3) << setw(10) << values[COUNTER_NANOSECONDS] / 1e9;
+		for(int j = 0; j < HARDWARE_COUNTERS; j++)
+		{
+			bool available = opened != -1 && (opened & (1 << j)) != 0;
+			if(available)
+				cout << setw(j == COUNTER_CACHE_MISSES ? 14 : 15) << values[j];
+			else
+				cout << setw(j == COUNTER_CACHE_MISSES ? 14 : 15) << "n/a";
+			if(j == COUNTER_INSTRUCTIONS)
+			{
+				bool ipc = available && (opened & 1) != 0 && values[COUNTER_CYCLES] > 0;
+				if(ipc)
+					cout << setprecision(2) << setw(6) << (double)values[COUNTER_INSTRUCTIONS] / values[COUNTER_CYCLES];
+				else
+					cout << setw(6) << "n/a";
+			}
+		}
+		cout << values[COUNTER_ALLOCATIONS] << endl;
+	}
+	cout.unsetf(ios::fixed);
+	cout << right;
+}
+
+profile_scope::profile_scope(phase_profiler* new_profiler, profile_phase new_phase)
+{
+	profiler = new_profiler;
+	phase = new_phase;
+	if(profiler != nullptr)
+		start = counter_reading::now();
+}
+
+profile_scope::~profile_scope()
+{
+	if(profiler != nullptr)
+		profiler->add(phase, start, counter_reading::now());
+}
@@ -0,0 +1,69 @@
+/*
+ * perfcounters.h
+ * This file contains the header information for the phase profiler which
+ * reads hardware performance counters around the phases of an evolution
+ */
+
+#include <atomic>
+using namespace std;
+
+#ifndef PERFCOUNTERS_H_
+#define PERFCOUNTERS_H_
+
+//The parts of an evolution that are measured. The searches of the fitness
+//games are part of the fitness test as well.
+enum profile_phase {PHASE_FITNESS_TEST, PHASE_OPTIMIZE_ACTION, PHASE_SPAWN_GENERATION, PHASE_COUNT};
+
+//The values kept for each phase. The first HARDWARE_COUNTERS come from the
+//processor through perf_event_open, the rest are counted by the program.
+enum profile_counter {COUNTER_CYCLES, COUNTER_INSTRUCTIONS, COUNTER_CACHE_MISSES, COUNTER_BRANCH_MISSES,
+		COUNTER_ALLOCATIONS, COUNTER_NANOSECONDS, COUNTER_CALLS, COUNTER_COUNT};
+const int HARDWARE_COUNTERS = COUNTER_ALLOCATIONS;
+
+//The counters of the calling thread at one moment
+class counter_reading
+{
+	public:
+		long long values[COUNTER_COUNT] = {};
+
+		//Reads the calling thread's counters, opening them on the thread's
+		//first reading. Counters the kernel refuses stay at zero.
+		static counter_reading now();
+};
+
+//Sums the counters of each phase over every thread that runs it, until the
+//totals are printed. Counters the kernel or the processor cannot provide,
+//as in most containers and virtual machines, are printed as n/a and the
+//times and allocation counts are still reported.
+class phase_profiler
+{
+	public:
+		phase_profiler();
+
+		//Adds the counts between two readings of one thread to a phase
+		void add(profile_phase phase, const counter_reading& start, const counter_reading& end);
+
+		//Prints the totals of every phase since the last call, then clears them
+		void display();
+
+	private:
+		atomic<long long> totals[PHASE_COUNT][COUNTER_COUNT];
+};
+
+//Adds the counts of the calling thread between its creation and its
+//destruction to a phase. Nothing is read when the profiler is null.
+class profile_scope
+{
+	public:
+		profile_scope(phase_profiler* new_profiler, profile_phase new_phase);
+		~profile_scope();
+		profile_scope(const profile_scope&) = delete;
+		profile_scope& operator=(const profile_scope&) = delete;
+
+	private:
+		phase_profiler* profiler;
+		profile_phase phase;
+		counter_reading start;
+};
+
+#endif /* PERFCOUNTERS_H_ */
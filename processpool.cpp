@@ -0,0 +1,246 @@
+/*
+ * processpool.cpp
+ * This file contains the function implementations for the process pool and
+ * the worker process loop
+ */
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <climits>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "evolutionaryframework.h"
+#include "processpool.h"
+using namespace std;
+
+//Reads or writes a whole message, returning false if the other end has gone
+static bool read_exact(int descriptor, void* data, size_t size)
+{
+	char* bytes = static_cast<char*>(data);
+	while(size > 0)
+	{
+		ssize_t count = read(descriptor, bytes, size);
+		if(count <= 0)
+			return false;
+		bytes += count;
+		size -= count;
+	}
+	return true;
+}
+
+static bool write_exact(int descriptor, const void* data, size_t size)
+{
+	const char* bytes = static_cast<const char*>(data);
+	while(size > 0)
+	{
+		ssize_t count = send(descriptor, bytes, size, MSG_NOSIGNAL);
+		if(count <= 0)
+			return false;
+		bytes += count;
+		size -= count;
+	}
+	return true;
+}
+
+process_pool::process_pool(int count, int new_timeout_seconds)
+{
+	timeout_seconds = new_timeout_seconds;
+	workers.resize(count);
+	for(unsigned int i = 0; i < workers.size(); i++)
+	{
+		start_worker(workers[i]);
+	}
+}
+
+//Closing a worker's socket ends its loop
+process_pool::~process_pool()
+{
+	for(unsigned int i = 0; i < workers.size(); i++)
+	{
+		if(workers[i].pid < 0)
+			continue;
+		close(workers[i].descriptor);
+		waitpid(workers[i].pid, nullptr, 0);
+	}
+}
+
+//Runs this program again as a worker holding one end of a socket pair. Only
+//the worker's end survives the exec, so workers do not hold each other's
+//sockets open.
+bool process_pool::start_worker(worker_process& worker)
+{
+	char path[PATH_MAX];
+	ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+	int sockets[2];
+	if(length <= 0 || socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets) != 0)
+	{
+		cout << "Failed to start a worker process" << endl;
+		return false;
+	}
+	path[length] = '\0';
+	string descriptor_text = to_string(sockets[1]);
+
+	pid_t pid = fork();
+	if(pid == 0)
+	{
+		fcntl(sockets[1], F_SETFD, 0);
+		execl(path, path, "--worker", descriptor_text.c_str(), (char*)nullptr);
+		_exit(127);
+	}
+	close(sockets[1]);
+	if(pid < 0)
+	{
+		close(sockets[0]);
+		cout << "Failed to start a worker process" << endl;
+		return false;
+	}
+	worker.pid = pid;
+	worker.descriptor = sockets[0];
+	worker.job = -1;
+	return true;
+}
+
+void process_pool::stop_worker(worker_process& worker)
+{
+	if(worker.pid < 0)
+		return;
+	kill(worker.pid, SIGKILL);
+	close(worker.descriptor);
+	waitpid(worker.pid, nullptr, 0);
+	worker.pid = -1;
+	worker.descriptor = -1;
+	worker.job = -1;
+}
+
+vector<process_result> process_pool::evaluate(vector<process_job>& jobs)
+{
+	vector<process_result> results(jobs.size());
+	vector<int> attempts(jobs.size(), 0);
+	deque<int> waiting;
+	for(unsigned int i = 0; i < jobs.size(); i++)
+	{
+		jobs[i].job_id = i;
+		waiting.push_back(i);
+	}
+	int remaining = jobs.size();
+
+	//Replaces a worker that failed its job and queues the job again at the
+	//front, unless it has failed too often
+	auto fail = [&](worker_process& worker, const char* reason)
+	{
+		int job = worker.job;
+		cout << "Worker process " << worker.pid << " " << reason << ", restarting it" << endl;
+		stop_worker(worker);
+		start_worker(worker);
+		restarts++;
+		if(job < 0)
+			return;
+		if(++attempts[job] >= MAX_ATTEMPTS)
+		{
+			cout << "Game " << job << " failed " << MAX_ATTEMPTS << " times and is scored as zero" << endl;
+			results[job] = process_result();
+			results[job].job_id = job;
+			remaining--;
+		}
+		else
+		{
+			waiting.push_front(job);
+			reissued++;
+		}
+	};
+
+	while(remaining > 0)
+	{
+		//Give every idle worker a game
+		for(unsigned int i = 0; i < workers.size() && !waiting.empty(); i++)
+		{
+			worker_process& worker = workers[i];
+			if(worker.job >= 0 || (worker.pid < 0 && !start_worker(worker)))
+				continue;
+			int job = waiting.front();
+			waiting.pop_front();
+			worker.job = job;
+			worker.job_start = chrono::steady_clock::now();
+			if(!write_exact(worker.descriptor, &jobs[job], sizeof(process_job)))
+				fail(worker, "closed its connection");
+		}
+
+		vector<pollfd> ready;
+		vector<int> ready_worker;
+		for(unsigned int i = 0; i < workers.size(); i++)
+		{
+			if(workers[i].job < 0)
+				continue;
+			pollfd entry;
+			entry.fd = workers[i].descriptor;
+			entry.events = POLLIN;
+			entry.revents = 0;
+			ready.push_back(entry);
+			ready_worker.push_back(i);
+		}
+		if(ready.empty())
+		{
+			//Every worker failed to start, so wait before trying again
+			if(!waiting.empty())
+				this_thread::sleep_for(chrono::milliseconds(100));
+			continue;
+		}
+		poll(ready.data(), ready.size(), 100);
+
+		for(unsigned int i = 0; i < ready.size(); i++)
+		{
+			worker_process& worker = workers[ready_worker[i]];
+			if(ready[i].revents != 0)
+			{
+				process_result result;
+				if(read_exact(worker.descriptor, &result, sizeof(result)) && (int)result.job_id == worker.job)
+				{
+					results[worker.job] = result;
+					worker.job = -1;
+					remaining--;
+				}
+				else
+					fail(worker, "stopped");
+			}
+			else if(timeout_seconds > 0 &&
+					chrono::steady_clock::now() - worker.job_start > chrono::seconds(timeout_seconds))
+				fail(worker, "timed out");
+		}
+	}
+	return results;
+}
+
+int run_process_worker(int descriptor)
+{
+	process_job job;
+	while(read_exact(descriptor, &job, sizeof(job)))
+	{
+		if((job.map_x != state::map_x_setting || job.map_y != state::map_y_setting) &&
+		   !state::set_map_size(job.map_x, job.map_y))
+			return 1;
+
+		genome player;
+		player.set_genes(vector<float>(job.genes, job.genes + min(job.gene_count, (int32_t)process_job::MAX_GENES)));
+		player.BEAM_WIDTH = job.beam_width;
+		player.BEAM_DEPTH = job.beam_depth;
+		player.MCTS_SIMULATIONS = job.mcts_simulations;
+		player.MCTS_ROLLOUT_DEPTH = job.mcts_rollout_depth;
+		player.MCTS_FOOD_SAMPLES = job.mcts_food_samples;
+		seed_game_rand(job.seed);
+
+		process_result result;
+		result.job_id = job.job_id;
+		result.fitness = player.play_game(false, job.turn_limit);
+		result.score = player.game_score;
+		result.turns = player.game_turns;
+		if(!write_exact(descriptor, &result, sizeof(result)))
+			return 1;
+	}
+	return 0;
+}
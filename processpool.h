@@ -0,0 +1,97 @@
+/*
+ * processpool.h
+ * This file contains the header information for the process pool, which
+ * plays fitness games in separate worker processes
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include <sys/types.h>
+using namespace std;
+
+#ifndef PROCESSPOOL_H_
+#define PROCESSPOOL_H_
+
+//The messages between the coordinator and its workers are these fixed size
+//records sent as raw bytes over a Unix domain socket pair. Both ends are the
+//same program on the same machine, so no byte order conversion is needed.
+
+//A request to play one game
+class process_job
+{
+	public:
+		static const int MAX_GENES = 32;
+
+		uint32_t job_id = 0;
+		uint32_t seed = 0;
+		int32_t turn_limit = 0;
+		int32_t map_x = 0;
+		int32_t map_y = 0;
+		int32_t beam_width = 0;
+		int32_t beam_depth = 0;
+		int32_t mcts_simulations = 0;
+		int32_t mcts_rollout_depth = 0;
+		int32_t mcts_food_samples = 0;
+		int32_t gene_count = 0;
+		float genes[MAX_GENES] = {};
+};
+
+//The outcome of a game
+class process_result
+{
+	public:
+		uint32_t job_id = 0;
+		int32_t fitness = 0;
+		int32_t score = 0;
+		int32_t turns = 0;
+};
+
+//A worker process and the job it is playing
+class worker_process
+{
+	public:
+		pid_t pid = -1;
+		int descriptor = -1;
+		//The position of the job in the batch, or -1 when idle
+		int job = -1;
+		chrono::steady_clock::time_point job_start;
+};
+
+//Starts worker processes running this program with --worker and hands them
+//one game at a time. A worker that exits, crashes or runs past the job
+//timeout is replaced and its game is issued again, so a bad game cannot
+//end the run. A game that has failed MAX_ATTEMPTS times is scored as zero.
+class process_pool
+{
+	public:
+		static const int MAX_ATTEMPTS = 3;
+
+		//Starts count workers. Jobs running longer than timeout_seconds are
+		//abandoned, where zero waits indefinitely.
+		process_pool(int count, int timeout_seconds = 0);
+		~process_pool();
+		process_pool(const process_pool&) = delete;
+		process_pool& operator=(const process_pool&) = delete;
+
+		//Plays every job and returns the results in the same order
+		vector<process_result> evaluate(vector<process_job>& jobs);
+
+		//The number of workers that have been replaced and games issued again
+		long long restarts = 0;
+		long long reissued = 0;
+
+	private:
+		vector<worker_process> workers;
+		int timeout_seconds;
+
+		bool start_worker(worker_process& worker);
+		void stop_worker(worker_process& worker);
+};
+
+//The loop run by a worker process. It plays the jobs read from the socket
+//until the coordinator closes it.
+int run_process_worker(int descriptor);
+
+#endif /* PROCESSPOOL_H_ */
@@ -0,0 +1,284 @@
+/*
+ * runconfig.cpp
+ * This file contains the function implementations for the run_config class
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include "runconfig.h"
+using namespace std;
+
+//Converts text to a number, rejecting text with anything after the number
+static bool parse_number(const string& text, double& number)
+{
+	char* end;
+	number = strtod(text.c_str(), &end);
+	return !text.empty() && *end == '\0';
+}
+
+bool run_config::set(const string& name, const string& value)
+{
+	double number;
+	if(!parse_number(value, number))
+		return false;
+
+	if(name == "POPULATION_SIZE")
+		POPULATION_SIZE = number;
+	else if(name == "GENERATION_LIMIT")
+		GENERATION_LIMIT = number;
+	else if(name == "MUTATION_CHANCE")
+		MUTATION_CHANCE = number;
+	else if(name == "MUTATION_STEP")
+		MUTATION_STEP = number;
+	else if(name == "ELITE_PROBABILITY_SLOPE")
+		ELITE_PROBABILITY_SLOPE = number;
+	else if(name == "SEEDS_PER_GENOME")
+		SEEDS_PER_GENOME = number;
+	else if(name == "TEST_TURNS")
+		TEST_TURNS = number;
+	else if(name == "END_TURNS")
+		END_TURNS = number;
+	else if(name == "DISPLAY_DELAY")
+		DISPLAY_DELAY = number;
+	else if(name == "SEED")
+		SEED = number;
+	else if(name == "BATCH_SIMULATION")
+		BATCH_SIMULATION = number;
+	else if(name == "STEADY_STATE")
+		STEADY_STATE = number;
+	else if(name == "SURROGATE")
+		SURROGATE = number;
+	else if(name == "SURROGATE_NEIGHBOURS")
+		SURROGATE_NEIGHBOURS = number;
+	else if(name == "SURROGATE_EXPLORATION")
+		SURROGATE_EXPLORATION = number;
+	else if(name == "DEDUPE_EPSILON")
+		DEDUPE_EPSILON = number;
+	else if(name == "CONVERGENCE_PATIENCE")
+		CONVERGENCE_PATIENCE = number;
+	else if(name == "CONVERGENCE_RESTART_FRACTION")
+		CONVERGENCE_RESTART_FRACTION = number;
+	else if(name == "CONVERGENCE_RESTARTS")
+		CONVERGENCE_RESTARTS = number;
+	else if(name == "CONVERGENCE_DIVERSITY")
+		CONVERGENCE_DIVERSITY = number;
+	else if(name == "OPTIMIZER")
+		OPTIMIZER = number;
+	else if(name == "TARGET_FITNESS")
+		TARGET_FITNESS = number;
+	else if(name == "BEAM_WIDTH")
+		BEAM_WIDTH = number;
+	else if(name == "BEAM_DEPTH")
+		BEAM_DEPTH = number;
+	else if(name == "MCTS_SIMULATIONS")
+		MCTS_SIMULATIONS = number;
+	else if(name == "MCTS_ROLLOUT_DEPTH")
+		MCTS_ROLLOUT_DEPTH = number;
+	else if(name == "MCTS_FOOD_SAMPLES")
+		MCTS_FOOD_SAMPLES = number;
+	else if(name == "CURRICULUM_TURNS")
+		CURRICULUM_TURNS = number;
+	else if(name == "CURRICULUM_THRESHOLD")
+		CURRICULUM_THRESHOLD = number;
+	else if(name == "THREADS")
+		THREADS = number;
+	else if(name == "PROCESSES")
+		PROCESSES = number;
+	else if(name == "PROCESS_TIMEOUT")
+		PROCESS_TIMEOUT = number;
+	else if(name == "PROFILE")
+		PROFILE = number;
+	else if(name == "MAP_X_LIMIT")
+		MAP_X_LIMIT = number;
+	else if(name == "MAP_Y_LIMIT")
+		MAP_Y_LIMIT = number;
+	else
+		return false;
+	return true;
+}
+
+string run_config::get(const string& name)
+{
+	ostringstream text;
+	if(name == "POPULATION_SIZE")
+		text << POPULATION_SIZE;
+	else if(name == "GENERATION_LIMIT")
+		text << GENERATION_LIMIT;
+	else if(name == "MUTATION_CHANCE")
+		text << MUTATION_CHANCE;
+	else if(name == "MUTATION_STEP")
+		text << MUTATION_STEP;
+	else if(name == "ELITE_PROBABILITY_SLOPE")
+		text << ELITE_PROBABILITY_SLOPE;
+	else if(name == "SEEDS_PER_GENOME")
+		text << SEEDS_PER_GENOME;
+	else if(name == "TEST_TURNS")
+		text << TEST_TURNS;
+	else if(name == "END_TURNS")
+		text << END_TURNS;
+	else if(name == "DISPLAY_DELAY")
+		text << DISPLAY_DELAY;
+	else if(name == "SEED")
+		text << SEED;
+	else if(name == "BATCH_SIMULATION")
+		text << BATCH_SIMULATION;
+	else if(name == "STEADY_STATE")
+		text << STEADY_STATE;
+	else if(name == "SURROGATE")
+		text << SURROGATE;
+	else if(name == "SURROGATE_NEIGHBOURS")
+		text << SURROGATE_NEIGHBOURS;
+	else if(name == "SURROGATE_EXPLORATION")
+		text << SURROGATE_EXPLORATION;
+	else if(name == "DEDUPE_EPSILON")
+		text << DEDUPE_EPSILON;
+	else if(name == "CONVERGENCE_PATIENCE")
+		text << CONVERGENCE_PATIENCE;
+	else if(name == "CONVERGENCE_RESTART_FRACTION")
+		text << CONVERGENCE_RESTART_FRACTION;
+	else if(name == "CONVERGENCE_RESTARTS")
+		text << CONVERGENCE_RESTARTS;
+	else if(name == "CONVERGENCE_DIVERSITY")
+		text << CONVERGENCE_DIVERSITY;
+	else if(name == "OPTIMIZER")
+		text << OPTIMIZER;
+	else if(name == "TARGET_FITNESS")
+		text << TARGET_FITNESS;
+	else if(name == "BEAM_WIDTH")
+		text << BEAM_WIDTH;
+	else if(name == "BEAM_DEPTH")
+		text << BEAM_DEPTH;
+	else if(name == "MCTS_SIMULATIONS")
+		text << MCTS_SIMULATIONS;
+	else if(name == "MCTS_ROLLOUT_DEPTH")
+		text << MCTS_ROLLOUT_DEPTH;
+	else if(name == "MCTS_FOOD_SAMPLES")
+		text << MCTS_FOOD_SAMPLES;
+	else if(name == "CURRICULUM_TURNS")
+		text << CURRICULUM_TURNS;
+	else if(name == "CURRICULUM_THRESHOLD")
+		text << CURRICULUM_THRESHOLD;
+	else if(name == "THREADS")
+		text << THREADS;
+	else if(name == "PROCESSES")
+		text << PROCESSES;
+	else if(name == "PROCESS_TIMEOUT")
+		text << PROCESS_TIMEOUT;
+	else if(name == "PROFILE")
+		text << PROFILE;
+	else if(name == "MAP_X_LIMIT")
+		text << MAP_X_LIMIT;
+	else if(name == "MAP_Y_LIMIT")
+		text << MAP_Y_LIMIT;
+	return text.str();
+}
+
+//The breeding step keeps the top half of a generation and needs at least
+//two elites to choose parents from
+bool run_config::validate()
+{
+	string problem;
+	if(POPULATION_SIZE < 4)
+		problem = "POPULATION_SIZE must be at least 4";
+	else if(GENERATION_LIMIT < 0)
+		problem = "GENERATION_LIMIT cannot be negative";
+	else if(SEEDS_PER_GENOME < 1)
+		problem = "SEEDS_PER_GENOME must be at least 1";
+	else if(TEST_TURNS < 1 || END_TURNS < 1)
+		problem = "TEST_TURNS and END_TURNS must be at least 1";
+	else if(THREADS < 0)
+		problem = "THREADS cannot be negative";
+	else if(PROCESSES < 0 || PROCESS_TIMEOUT < 0)
+		problem = "PROCESSES and PROCESS_TIMEOUT cannot be negative";
+	else if(SURROGATE_NEIGHBOURS < 1)
+		problem = "SURROGATE_NEIGHBOURS must be at least 1";
+	else if(SURROGATE_EXPLORATION < 0 || SURROGATE_EXPLORATION > 1)
+		problem = "SURROGATE_EXPLORATION must be between 0 and 1";
+	else if(DEDUPE_EPSILON < 0)
+		problem = "DEDUPE_EPSILON cannot be negative";
+	else if(CONVERGENCE_PATIENCE < 0 || CONVERGENCE_RESTARTS < 0 || CONVERGENCE_DIVERSITY < 0)
+		problem = "CONVERGENCE_PATIENCE, CONVERGENCE_RESTARTS and CONVERGENCE_DIVERSITY cannot be negative";
+	else if(CONVERGENCE_RESTART_FRACTION < 0 || CONVERGENCE_RESTART_FRACTION > 1)
+		problem = "CONVERGENCE_RESTART_FRACTION must be between 0 and 1";
+	else if(OPTIMIZER < 0 || OPTIMIZER > 1)
+		problem = "OPTIMIZER must be 0 for the genetic algorithm or 1 for CMA-ES";
+	else if(BEAM_WIDTH < 0 || BEAM_DEPTH < 1)
+		problem = "BEAM_WIDTH cannot be negative and BEAM_DEPTH must be at least 1";
+	else if(MCTS_SIMULATIONS < 0 || MCTS_ROLLOUT_DEPTH < 0 || MCTS_FOOD_SAMPLES < 1)
+		problem = "MCTS_SIMULATIONS and MCTS_ROLLOUT_DEPTH cannot be negative and MCTS_FOOD_SAMPLES must be at least 1";
+	else if(MCTS_SIMULATIONS > 0 && BEAM_WIDTH > 0)
+		problem = "Only one of BEAM_WIDTH and MCTS_SIMULATIONS can be set";
+	else if(MCTS_SIMULATIONS > 0 && BATCH_SIMULATION)
+		problem = "MCTS_SIMULATIONS cannot be combined with BATCH_SIMULATION";
+	else if(CURRICULUM_TURNS < 0)
+		problem = "CURRICULUM_TURNS cannot be negative";
+	else if(CURRICULUM_THRESHOLD <= 0 || CURRICULUM_THRESHOLD > 1)
+		problem = "CURRICULUM_THRESHOLD must be above 0 and at most 1";
+	if(problem.empty())
+		return true;
+	cout << "Invalid settings: " << problem << endl;
+	return false;
+}
+
+vector<string> run_config::names()
+{
+	return {"POPULATION_SIZE", "GENERATION_LIMIT", "MUTATION_CHANCE", "MUTATION_STEP",
+			"ELITE_PROBABILITY_SLOPE", "SEEDS_PER_GENOME", "TEST_TURNS", "END_TURNS",
+			"DISPLAY_DELAY", "SEED", "BATCH_SIMULATION", "STEADY_STATE",
+			"SURROGATE", "SURROGATE_NEIGHBOURS", "SURROGATE_EXPLORATION", "DEDUPE_EPSILON",
+			"CONVERGENCE_PATIENCE", "CONVERGENCE_RESTART_FRACTION", "CONVERGENCE_RESTARTS",
+			"CONVERGENCE_DIVERSITY", "OPTIMIZER", "TARGET_FITNESS", "BEAM_WIDTH", "BEAM_DEPTH",
+			"MCTS_SIMULATIONS", "MCTS_ROLLOUT_DEPTH", "MCTS_FOOD_SAMPLES",
+			"CURRICULUM_TURNS", "CURRICULUM_THRESHOLD", "THREADS",
+			"PROCESSES", "PROCESS_TIMEOUT", "PROFILE", "MAP_X_LIMIT", "MAP_Y_LIMIT"};
+}
+
+//Reads every setting in a file, reporting the first line that cannot be used
+bool run_config::load_from_file(const char* file_name)
+{
+	ifstream file;
+	file.open(file_name);
+	if(!file.is_open())
+	{
+		cout << "Failed to load settings in " << file_name << endl;
+		return false;
+	}
+
+	string line;
+	string name;
+	string value;
+	int line_number = 0;
+	while(getline(file, line))
+	{
+		line_number++;
+		if(!split_setting(line, name, value))
+			continue;
+		if(!set(name, value))
+		{
+			cout << "Invalid setting on line " << line_number << " of " << file_name << ": " << line << endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+//Strips the comment and surrounding spaces from a line and splits it at the
+//equals sign
+bool split_setting(const string& line, string& name, string& value)
+{
+	const string SPACES = " \t\r";
+	string text = line.substr(0, line.find('#'));
+	size_t equals = text.find('=');
+	if(equals == string::npos)
+		return false;
+
+	name = text.substr(0, equals);
+	value = text.substr(equals + 1);
+	name.erase(0, name.find_first_not_of(SPACES));
+	name.erase(name.find_last_not_of(SPACES) + 1);
+	value.erase(0, value.find_first_not_of(SPACES));
+	value.erase(value.find_last_not_of(SPACES) + 1);
+	return !name.empty();
+}
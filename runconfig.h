@@ -0,0 +1,114 @@
+/*
+ * runconfig.h
+ * This file contains the header information for the run_config class which
+ * holds the settings of an evolution run
+ */
+
+#include <string>
+#include <vector>
+using namespace std;
+
+#ifndef RUNCONFIG_H_
+#define RUNCONFIG_H_
+
+//The settings of an evolution run. The defaults are the values the program
+//has always used. Settings are read from files of NAME = value lines, where
+//# starts a comment, or from NAME=VALUE command line options.
+class run_config
+{
+	public:
+		//Evolution settings, see the evolution class
+		int POPULATION_SIZE = 30;
+		int GENERATION_LIMIT = 40;
+		float MUTATION_CHANCE = 0.05;
+		float MUTATION_STEP = 0.2;
+		float ELITE_PROBABILITY_SLOPE = 0.01;
+		int SEEDS_PER_GENOME = 1;
+
+		//The number of turns at which the fitness test cuts off a genome's game
+		int TEST_TURNS = 500;
+		//The number of turns the fittest genome is allowed to play while the
+		//game is displayed after the last evolution
+		int END_TURNS = 1000;
+		//The number of milliseconds each displayed state is shown for
+		int DISPLAY_DELAY = 100;
+		//Seeds the breeding of genomes so a run is reproducible
+		unsigned int SEED = 5;
+		//Plays the fitness test games in a lockstep batch simulation
+		int BATCH_SIMULATION = 0;
+		//Evolves a continuously ranked population instead of generations
+		int STEADY_STATE = 0;
+		//Skips the games of children a surrogate model predicts will not
+		//reach the elites, except for an exploration fraction of them
+		int SURROGATE = 0;
+		int SURROGATE_NEIGHBOURS = 5;
+		float SURROGATE_EXPLORATION = 0.2;
+		//Children whose genes are within this distance of a genome that has
+		//played reuse its fitness, where zero plays every child
+		float DEDUPE_EPSILON = 0;
+		//Stops or partly re-randomizes a run that has not improved for
+		//CONVERGENCE_PATIENCE generations, see convergence_monitor. Zero
+		//patience always runs GENERATION_LIMIT generations.
+		int CONVERGENCE_PATIENCE = 0;
+		float CONVERGENCE_RESTART_FRACTION = 0.5;
+		int CONVERGENCE_RESTARTS = 2;
+		float CONVERGENCE_DIVERSITY = 0;
+		//Breeds with the genetic algorithm (0) or CMA-ES (1), see optimizer.h
+		int OPTIMIZER = 0;
+		//Ends the run once the fittest genome of a generation reaches this
+		//fitness, where zero always runs GENERATION_LIMIT generations
+		int TARGET_FITNESS = 0;
+		//Chooses moves with a beam search keeping BEAM_WIDTH states per ply
+		//out to BEAM_DEPTH plies, where zero width uses the exhaustive search
+		int BEAM_WIDTH = 0;
+		int BEAM_DEPTH = 12;
+		//Chooses moves with a Monte Carlo tree search of MCTS_SIMULATIONS
+		//simulations, each rolling out MCTS_ROLLOUT_DEPTH moves past the
+		//tree and sampling MCTS_FOOD_SAMPLES placements of eaten food, where
+		//zero simulations uses the other searches
+		int MCTS_SIMULATIONS = 0;
+		int MCTS_ROLLOUT_DEPTH = 6;
+		int MCTS_FOOD_SAMPLES = 4;
+		//The turn limit of the first generation's fitness games, raised as the
+		//population survives longer until it reaches TEST_TURNS, where zero
+		//always plays TEST_TURNS, and the share of the limit the median game
+		//must last to raise it, see turn_curriculum
+		int CURRICULUM_TURNS = 0;
+		float CURRICULUM_THRESHOLD = 0.9;
+		//The number of worker threads, where zero uses every hardware thread
+		int THREADS = 0;
+		//The number of worker processes that play the fitness games instead
+		//of the worker threads, where zero plays them in this process, and
+		//the seconds after which a worker's game is abandoned, where zero
+		//never abandons a game
+		int PROCESSES = 0;
+		int PROCESS_TIMEOUT = 0;
+		//Prints the hardware counters, time and allocations of the fitness
+		//test, the searches and the breeding of every generation
+		int PROFILE = 0;
+		//The map size, which applies to every run in the process
+		int MAP_X_LIMIT = 25;
+		int MAP_Y_LIMIT = 15;
+
+		//Sets the named setting. Returns false if the name is unknown or the
+		//value is not a number.
+		bool set(const string& name, const string& value);
+		//Returns the value of the named setting as text
+		string get(const string& name);
+		//Reads NAME = value lines. Returns false if the file cannot be read
+		//or contains an unknown setting.
+		bool load_from_file(const char* file_name);
+
+		//Prints the first setting that cannot be used and returns false, or
+		//returns true if every setting is usable
+		bool validate();
+
+		//Returns the names of every setting
+		static vector<string> names();
+};
+
+//Splits a NAME = value line into its trimmed parts, ignoring comments.
+//Returns false for blank lines and lines without an equals sign.
+bool split_setting(const string& line, string& name, string& value);
+
+#endif /* RUNCONFIG_H_ */
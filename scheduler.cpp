@@ -0,0 +1,208 @@
+/*
+ * scheduler.cpp
+ * This file contains the function implementations for the work stealing
+ * task scheduler
+ */
+
+#include <iostream>
+#include <algorithm>
+#include "scheduler.h"
+using namespace std;
+
+//Identifies the scheduler and deque owned by the current thread so that
+//nested submissions and waits can stay on the calling worker
+static thread_local scheduler* current_scheduler = nullptr;
+static thread_local int current_worker = -1;
+
+//Starts the worker threads, each with its own empty deque
+scheduler::scheduler(int thread_count)
+{
+	if(thread_count <= 0)
+		thread_count = max(1u, thread::hardware_concurrency());
+
+	for(int i = 0; i < thread_count; i++)
+	{
+		queues.push_back(unique_ptr<worker_queue>(new worker_queue()));
+	}
+	utilization_start = chrono::steady_clock::now();
+	for(int i = 0; i < thread_count; i++)
+	{
+		workers.push_back(thread(&scheduler::worker_loop, this, i));
+	}
+}
+
+//Lets the workers drain their remaining tasks and joins them
+scheduler::~scheduler()
+{
+	{
+		lock_guard<mutex> guard(sleep_lock);
+		stopping = true;
+	}
+	wake.notify_all();
+	for(unsigned int i = 0; i < workers.size(); i++)
+	{
+		workers[i].join();
+	}
+}
+
+//Places the task on the calling worker's deque, or spreads tasks from
+//outside threads across the deques, then wakes a sleeping worker
+void scheduler::submit(task_group& group, function<void()> work)
+{
+	scheduled_task task;
+	task.work = work;
+	task.group = &group;
+	group.pending++;
+
+	int index;
+	if(current_scheduler == this)
+		index = current_worker;
+	else
+		index = next_queue++ % queues.size();
+
+	{
+		lock_guard<mutex> guard(queues[index]->lock);
+		queues[index]->tasks.push_back(task);
+	}
+	queued_tasks++;
+	{
+		lock_guard<mutex> guard(sleep_lock);
+	}
+	wake.notify_one();
+}
+
+//Waits for every task in the group. Workers help with queued tasks while
+//they wait so nested groups can never starve the pool.
+void scheduler::wait(task_group& group)
+{
+	if(current_scheduler == this)
+	{
+		scheduled_task task;
+		while(group.pending > 0)
+		{
+			if(pop_task(current_worker, task))
+				run_task(current_worker, task);
+			else
+				this_thread::yield();
+		}
+		lock_guard<mutex> guard(group.lock);
+		return;
+	}
+
+	unique_lock<mutex> guard(group.lock);
+	group.done.wait(guard, [&group]{return group.pending == 0;});
+}
+
+int scheduler::size()
+{
+	return workers.size();
+}
+
+//Runs tasks until the scheduler is destroyed, sleeping while every deque
+//is empty
+void scheduler::worker_loop(int index)
+{
+	current_scheduler = this;
+	current_worker = index;
+
+	scheduled_task task;
+	while(true)
+	{
+		if(pop_task(index, task))
+		{
+			run_task(index, task);
+			continue;
+		}
+		unique_lock<mutex> guard(sleep_lock);
+		wake.wait(guard, [this]{return queued_tasks > 0 || stopping;});
+		if(stopping && queued_tasks == 0)
+			return;
+	}
+}
+
+//Takes the newest task from the worker's own deque, or steals the oldest
+//task from another worker's deque when its own is empty
+bool scheduler::pop_task(int index, scheduled_task& task)
+{
+	{
+		worker_queue& own = *queues[index];
+		lock_guard<mutex> guard(own.lock);
+		if(!own.tasks.empty())
+		{
+			task = own.tasks.back();
+			own.tasks.pop_back();
+			queued_tasks--;
+			return true;
+		}
+	}
+
+	for(unsigned int offset = 1; offset < queues.size(); offset++)
+	{
+		worker_queue& victim = *queues[(index + offset) % queues.size()];
+		lock_guard<mutex> guard(victim.lock);
+		if(!victim.tasks.empty())
+		{
+			task = victim.tasks.front();
+			victim.tasks.pop_front();
+			queued_tasks--;
+			queues[index]->steals++;
+			return true;
+		}
+	}
+	return false;
+}
+
+//Runs a task, records how long the worker was busy with it, and releases
+//anyone waiting on the task's group once the group is finished
+void scheduler::run_task(int index, scheduled_task& task)
+{
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	task.work();
+	long long elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+
+	queues[index]->busy_nanoseconds += elapsed;
+	queues[index]->tasks_run++;
+	long long longest = longest_task_nanoseconds;
+	while(elapsed > longest && !longest_task_nanoseconds.compare_exchange_weak(longest, elapsed));
+
+	//The count is released under the group lock so a waiter cannot destroy
+	//the group while it is still being notified
+	task_group* group = task.group;
+	task.work = nullptr;
+	lock_guard<mutex> guard(group->lock);
+	if(--group->pending == 0)
+		group->done.notify_all();
+}
+
+//Prints the utilization of each worker since the last reset
+void scheduler::display_utilization()
+{
+	double wall = chrono::duration<double>(chrono::steady_clock::now() - utilization_start).count();
+	long long tasks = 0;
+	long long steals = 0;
+
+	cout << "Worker Utilization: ";
+	for(unsigned int i = 0; i < queues.size(); i++)
+	{
+		double busy = queues[i]->busy_nanoseconds / 1e9;
+		cout << static_cast<int>(wall > 0 ? 100 * busy / wall : 0) << "%,";
+		tasks += queues[i]->tasks_run;
+		steals += queues[i]->steals;
+	}
+	cout << endl;
+	cout << "Tasks: " << tasks << " Steals: " << steals << " Wall Time: " << wall
+		 << "s Longest Task: " << longest_task_nanoseconds / 1e9 << "s" << endl;
+}
+
+//Starts a new utilization measurement window
+void scheduler::reset_utilization()
+{
+	for(unsigned int i = 0; i < queues.size(); i++)
+	{
+		queues[i]->busy_nanoseconds = 0;
+		queues[i]->tasks_run = 0;
+		queues[i]->steals = 0;
+	}
+	longest_task_nanoseconds = 0;
+	utilization_start = chrono::steady_clock::now();
+}
@@ -0,0 +1,97 @@
+/*
+ * scheduler.h
+ * This file contains the header information for the work stealing task
+ * scheduler used to evaluate games concurrently
+ */
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+//A task group counts the outstanding tasks of one batch of work so a caller
+//can wait for its own tasks while other batches keep sharing the workers
+class task_group
+{
+	public:
+		atomic<int> pending{0};
+		mutex lock;
+		condition_variable done;
+};
+
+//A unit of work and the group it reports its completion to
+class scheduled_task
+{
+	public:
+		function<void()> work;
+		task_group* group = nullptr;
+};
+
+//Each worker owns a deque of tasks. The owner pushes and pops at the back
+//while idle workers steal from the front of the other workers' deques.
+class worker_queue
+{
+	public:
+		mutex lock;
+		deque<scheduled_task> tasks;
+
+		//Utilization counters since the last reset
+		atomic<long long> busy_nanoseconds{0};
+		atomic<long long> tasks_run{0};
+		atomic<long long> steals{0};
+};
+
+//The scheduler keeps a fixed set of worker threads alive for the whole run
+//so each generation only pays for queueing its games, not for thread startup
+class scheduler
+{
+	public:
+		//A thread count of zero uses one worker per hardware thread
+		scheduler(int thread_count = 0);
+		~scheduler();
+
+		//Queues work as part of a group. Tasks submitted from a worker go to
+		//that worker's own deque so nested work stays local until stolen.
+		void submit(task_group& group, function<void()> work);
+		//Blocks until every task in the group has finished. A worker that
+		//waits keeps running queued tasks instead of sleeping.
+		void wait(task_group& group);
+
+		int size();
+
+		//Prints the share of wall time each worker spent running tasks, the
+		//number of steals, and the longest task since the last reset
+		void display_utilization();
+		void reset_utilization();
+
+	private:
+		vector<unique_ptr<worker_queue>> queues;
+		vector<thread> workers;
+
+		//Sleeping workers are woken when tasks are queued
+		mutex sleep_lock;
+		condition_variable wake;
+		atomic<int> queued_tasks{0};
+		bool stopping = false;
+
+		//Round robin placement for tasks submitted from outside the workers
+		atomic<unsigned int> next_queue{0};
+
+		chrono::steady_clock::time_point utilization_start;
+		atomic<long long> longest_task_nanoseconds{0};
+
+		void worker_loop(int index);
+		bool pop_task(int index, scheduled_task& task);
+		void run_task(int index, scheduled_task& task);
+};
+
+#endif /* SCHEDULER_H_ */
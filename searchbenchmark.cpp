@@ -0,0 +1,143 @@
+/*
+ * searchbenchmark.cpp
+ * This file contains the function implementations for the search benchmark
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include "searchbenchmark.h"
+using namespace std;
+
+void search_benchmark::run(genome& player)
+{
+	//The positions are the states the genome chose moves from
+	seed_game_rand(SEED);
+	positions.clear();
+	game test_game;
+	for(int i = 0; i < TURN_LIMIT && !test_game.current_state.loss; i++)
+	{
+		positions.push_back(test_game.current_state);
+		test_game.update(player.optimize_action(test_game.current_state));
+	}
+
+	results.clear();
+	heuristic_plan plan = player.plan_heuristic(test_game.current_state);
+	for(int depth = 1; depth <= MAX_DEPTH; depth++)
+	{
+		search_benchmark_result result;
+		result.depth = depth;
+		for(unsigned int i = 0; i < positions.size(); i++)
+		{
+			result.nodes += count_nodes(positions[i], depth);
+		}
+
+		//Times whole passes over the positions, keeping each pass's values
+		//so the two searches can be compared
+		auto measure = [this](function<int(state&)> search, vector<int>& values)
+		{
+			long long passes = 0;
+			chrono::steady_clock::time_point start = chrono::steady_clock::now();
+			double seconds = 0;
+			do
+			{
+				for(unsigned int i = 0; i < positions.size(); i++)
+				{
+					values[i] = search(positions[i]);
+				}
+				passes++;
+				seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+			} while(seconds < MIN_SECONDS);
+			return passes / seconds;
+		};
+
+		vector<int> recursive_values(positions.size());
+		vector<int> unrolled_values(positions.size());
+		double recursive_passes = measure([&player, depth](state& s)
+		{
+			return player.optimize_heuristic_at_depth(s, depth);
+		}, recursive_values);
+		double unrolled_passes = measure([&player, depth, &plan](state& s)
+		{
+			return player.search_at_depth(s, depth, plan);
+		}, unrolled_values);
+
+		result.recursive_nodes_per_second = recursive_passes * result.nodes;
+		result.unrolled_nodes_per_second = unrolled_passes * result.nodes;
+		result.matched = recursive_values == unrolled_values;
+		for(unsigned int i = 0; i < positions.size() && result.actions_matched; i++)
+		{
+			result.actions_matched = same_best_actions(player, positions[i], depth, plan);
+		}
+		results.push_back(result);
+	}
+
+	display();
+}
+
+//Prints one row per depth
+void search_benchmark::display()
+{
+	cout << "Search benchmark on " << positions.size() << " positions" << endl;
+	cout << left << setw(7) << "Depth" << setw(12) << "Nodes"
+		 << setw(18) << "Recursive/sec" << setw(18) << "Unrolled/sec"
+		 << setw(10) << "Speedup" << setw(8) << "Values" << "Actions" << endl;
+	cout << fixed << setprecision(0);
+	for(unsigned int i = 0; i < results.size(); i++)
+	{
+		search_benchmark_result& result = results[i];
+		cout << setw(7) << result.depth << setw(12) << result.nodes
+			 << setw(18) << result.recursive_nodes_per_second
+			 << setw(18) << result.unrolled_nodes_per_second
+			 << setprecision(2) << setw(10) << result.unrolled_nodes_per_second / result.recursive_nodes_per_second
+			 << setprecision(0) << setw(8) << (result.matched ? "same" : "DIFFERENT")
+			 << (result.actions_matched ? "same" : "DIFFERENT") << endl;
+	}
+	cout.unsetf(ios::fixed);
+	cout << right;
+}
+
+//The number of states a search to the depth visits, counting the root
+long long search_benchmark::count_nodes(state& s, int depth)
+{
+	if(depth == 0 || s.loss)
+		return 1;
+	long long nodes = 1;
+	coordinate actions[state::MAX_ACTIONS];
+	int count = s.actions(actions);
+	for(int i = 0; i < count; i++)
+	{
+		state new_state = s.result(actions[i]);
+		nodes += count_nodes(new_state, depth - 1);
+	}
+	return nodes;
+}
+
+//Compares the actions tied for the best value below each root action, with
+//the compiled search given the best value so far as its floor like a serial
+//search_root
+bool search_benchmark::same_best_actions(genome& player, state& s, int depth, const heuristic_plan& plan)
+{
+	vector<coordinate> actions = s.actions();
+	vector<int> recursive_values;
+	vector<int> planned_values;
+	int best_so_far = INT_MIN;
+	for(unsigned int i = 0; i < actions.size(); i++)
+	{
+		state new_state = s.result(actions[i]);
+		recursive_values.push_back(player.optimize_heuristic_at_depth(new_state, depth - 1));
+		planned_values.push_back(player.search_at_depth(new_state, depth - 1, plan, best_so_far));
+		best_so_far = max(best_so_far, planned_values.back());
+	}
+	int recursive_best = *max_element(recursive_values.begin(), recursive_values.end());
+	int planned_best = *max_element(planned_values.begin(), planned_values.end());
+	for(unsigned int i = 0; i < actions.size(); i++)
+	{
+		if((recursive_values[i] == recursive_best) != (planned_values[i] == planned_best))
+			return false;
+	}
+	return recursive_best == planned_best;
+}
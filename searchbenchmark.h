@@ -0,0 +1,57 @@
+/*
+ * searchbenchmark.h
+ * This file contains the header information for the search benchmark which
+ * compares the recursive game tree search with the compiled fixed depth one
+ */
+
+#include <vector>
+#include "evolutionaryframework.h"
+using namespace std;
+
+#ifndef SEARCHBENCHMARK_H_
+#define SEARCHBENCHMARK_H_
+
+//The measurements of both searches at one depth
+class search_benchmark_result
+{
+	public:
+		int depth = 0;
+		long long nodes = 0;
+		double recursive_nodes_per_second = 0;
+		double unrolled_nodes_per_second = 0;
+		//Whether both searches returned the same value for every position,
+		//and whether choosing a move with each search, where the compiled
+		//search cuts off actions below the best so far, picks the same set
+		//of best actions
+		bool matched = true;
+		bool actions_matched = true;
+};
+
+//Searches every position of one game with both optimize_heuristic_at_depth
+//and search_at_depth, which uses the genome's heuristic plan, repeating
+//each pass until it has run for at least MIN_SECONDS, and reports the
+//nodes searched per second
+class search_benchmark
+{
+	public:
+		//The game the positions are taken from
+		int TURN_LIMIT = 500;
+		unsigned int SEED = 5;
+		//The depths measured, from one up
+		int MAX_DEPTH = 4;
+		double MIN_SECONDS = 0.5;
+
+		vector<state> positions;
+		vector<search_benchmark_result> results;
+
+		//Plays a game with the genome and measures its searches on the
+		//positions of that game
+		void run(genome& player);
+		void display();
+
+	private:
+		long long count_nodes(state& s, int depth);
+		bool same_best_actions(genome& player, state& s, int depth, const heuristic_plan& plan);
+};
+
+#endif /* SEARCHBENCHMARK_H_ */
@@ -0,0 +1,202 @@
+/*
+ * snapshotring.cpp
+ * This file contains the function implementations for the snapshot ring and
+ * its viewer
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "mctsplanner.h"
+#include "snapshotring.h"
+using namespace std;
+
+static const char RING_MAGIC[8] = {'S', 'N', 'A', 'K', 'E', 'R', 'N', 'G'};
+static const uint32_t RING_VERSION = 3;
+
+//The ring is shared between processes, so its counters must not be
+//implemented with a lock private to one process
+static_assert(atomic<uint64_t>::is_always_lock_free, "the snapshot ring needs lock free 64 bit atomics");
+
+snapshot_ring::~snapshot_ring()
+{
+	if(memory != nullptr)
+		munmap(memory, sizeof(snapshot_ring_memory));
+}
+
+bool snapshot_ring::create(const char* name)
+{
+	return attach(name, true);
+}
+
+bool snapshot_ring::open(const char* name)
+{
+	return attach(name, false);
+}
+
+//Maps the shared memory object. A new ring is sized and initialized before
+//its header is written, so a viewer never accepts a half made ring.
+bool snapshot_ring::attach(const char* name, bool creating)
+{
+	string object_name = name[0] == '/' ? name : string("/") + name;
+	int descriptor = shm_open(object_name.c_str(), creating ? O_RDWR | O_CREAT : O_RDWR, 0644);
+	if(descriptor < 0 || (creating && ftruncate(descriptor, sizeof(snapshot_ring_memory)) != 0))
+	{
+		if(descriptor >= 0)
+			close(descriptor);
+		cout << "Failed to open snapshot ring " << name << endl;
+		return false;
+	}
+	void* mapping = mmap(nullptr, sizeof(snapshot_ring_memory), PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+	close(descriptor);
+	if(mapping == MAP_FAILED)
+	{
+		cout << "Failed to map snapshot ring " << name << endl;
+		return false;
+	}
+	memory = static_cast<snapshot_ring_memory*>(mapping);
+
+	if(creating)
+	{
+		memset(memory->magic, 0, sizeof(memory->magic));
+		memory->version = RING_VERSION;
+		memory->frame_size = sizeof(snapshot_frame);
+		memory->published.store(0);
+		for(int i = 0; i < snapshot_ring_memory::SLOT_COUNT; i++)
+		{
+			memory->slots[i].sequence.store(0);
+		}
+		atomic_thread_fence(memory_order_release);
+		memcpy(memory->magic, RING_MAGIC, sizeof(RING_MAGIC));
+	}
+	else if(memcmp(memory->magic, RING_MAGIC, sizeof(RING_MAGIC)) != 0 ||
+			memory->version != RING_VERSION || memory->frame_size != sizeof(snapshot_frame))
+	{
+		munmap(memory, sizeof(snapshot_ring_memory));
+		memory = nullptr;
+		cout << name << " is not a snapshot ring" << endl;
+		return false;
+	}
+	return true;
+}
+
+void snapshot_ring::publish(const snapshot_frame& frame)
+{
+	uint64_t n = memory->published.load(memory_order_relaxed);
+	snapshot_slot& slot = memory->slots[n % snapshot_ring_memory::SLOT_COUNT];
+	uint64_t sequence = slot.sequence.load(memory_order_relaxed);
+	slot.sequence.store(sequence + 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	memcpy(&slot.frame, &frame, sizeof(frame));
+	slot.sequence.store(sequence + 2, memory_order_release);
+	memory->published.store(n + 1, memory_order_release);
+}
+
+uint64_t snapshot_ring::published()
+{
+	return memory->published.load(memory_order_acquire);
+}
+
+bool snapshot_ring::read(uint64_t n, snapshot_frame& frame)
+{
+	uint64_t count = published();
+	if(n >= count || count - n > snapshot_ring_memory::SLOT_COUNT)
+		return false;
+	snapshot_slot& slot = memory->slots[n % snapshot_ring_memory::SLOT_COUNT];
+	uint64_t before = slot.sequence.load(memory_order_acquire);
+	memcpy(&frame, &slot.frame, sizeof(frame));
+	atomic_thread_fence(memory_order_acquire);
+	uint64_t after = slot.sequence.load(memory_order_relaxed);
+	//The slot must still hold frame n, which was its (n / SLOT_COUNT)th write
+	return before == after && before == 2 * (n / snapshot_ring_memory::SLOT_COUNT + 1);
+}
+
+bool snapshot_ring::latest(snapshot_frame& frame)
+{
+	//A frame can only be overwritten by a writer lapping the ring, so a
+	//failed read is retried on the newer frame
+	for(int attempt = 0; attempt < snapshot_ring_memory::SLOT_COUNT; attempt++)
+	{
+		uint64_t count = published();
+		if(count == 0)
+			return false;
+		if(read(count - 1, frame))
+			return true;
+	}
+	return false;
+}
+
+bool snapshot_viewer::run(const char* name, const int frame_delay)
+{
+	snapshot_ring ring;
+	if(!ring.open(name))
+		return false;
+
+	snapshot_frame frame;
+	while(!ring.latest(frame))
+	{
+		this_thread::sleep_for(chrono::milliseconds(frame_delay));
+	}
+
+	while(true)
+	{
+		//Replay the newest champion's game
+		ring.latest(frame);
+		if(!state::set_map_size(frame.map_x, frame.map_y))
+			return false;
+		genome champion;
+		champion.id = frame.champion_id;
+		champion.set_genes(vector<float>(frame.genes, frame.genes + min(frame.gene_count, (int32_t)snapshot_frame::MAX_GENES)));
+		champion.BEAM_WIDTH = frame.beam_width;
+		champion.BEAM_DEPTH = frame.beam_depth;
+		champion.MCTS_SIMULATIONS = frame.mcts_simulations;
+		champion.MCTS_ROLLOUT_DEPTH = frame.mcts_rollout_depth;
+		champion.MCTS_FOOD_SAMPLES = frame.mcts_food_samples;
+		seed_game_rand(frame.game_seed);
+		game replay;
+		//The tree is kept for the whole game and seeded as in play_game
+		unique_ptr<mcts_planner> tree;
+		if(champion.MCTS_SIMULATIONS > 0)
+			tree.reset(new mcts_planner(champion.MCTS_SIMULATIONS, champion.MCTS_ROLLOUT_DEPTH,
+					champion.MCTS_FOOD_SAMPLES, game_rand()));
+		for(int i = 0; i < frame.turn_limit && !replay.current_state.loss; i++)
+		{
+			display(ring, frame, replay.current_state, replay.turn);
+			this_thread::sleep_for(chrono::milliseconds(frame_delay));
+			replay.update(champion.optimize_action(replay.current_state, tree.get()));
+		}
+		display(ring, frame, replay.current_state, replay.turn);
+		this_thread::sleep_for(chrono::milliseconds(frame_delay * 10));
+	}
+}
+
+//Prints the state being replayed below the newest generation's statistics
+//and the best fitness of the recent generations
+void snapshot_viewer::display(snapshot_ring& ring, snapshot_frame& frame, state& s, int turn)
+{
+	snapshot_frame newest;
+	if(!ring.latest(newest))
+		newest = frame;
+	cout << "Generation: " << newest.generation << " Best: " << newest.best_fitness
+		 << " Median: " << newest.median_fitness << " Worst: " << newest.worst_fitness
+		 << " Elapsed: " << (int)newest.seconds << "s" << endl;
+
+	cout << "Recent Best Fitness: ";
+	uint64_t count = ring.published();
+	snapshot_frame recent;
+	for(uint64_t n = count - min<uint64_t>(count, 8); n < count; n++)
+	{
+		if(ring.read(n, recent))
+			cout << recent.best_fitness << ",";
+	}
+	cout << endl;
+
+	cout << "Replaying Genome ID: " << frame.champion_id << " of Generation " << frame.generation << endl;
+	cout << "Current Turn: " << turn << " Score: " << s.score << endl;
+	s.display();
+}
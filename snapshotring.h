@@ -0,0 +1,114 @@
+/*
+ * snapshotring.h
+ * This file contains the header information for the snapshot ring, which
+ * publishes the progress of an evolution through shared memory, and the
+ * viewer which shows it from another process
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include "evolutionaryframework.h"
+using namespace std;
+
+#ifndef SNAPSHOTRING_H_
+#define SNAPSHOTRING_H_
+
+//The progress of an evolution after one generation. The champion's game is
+//not copied turn by turn; a viewer replays it from the champion's genes and
+//the seed of the game it played, which gives the same game since games are
+//reproducible from their seeds.
+class snapshot_frame
+{
+	public:
+		static const int MAX_GENES = 32;
+
+		int32_t generation = 0;
+		int32_t best_fitness = 0;
+		int32_t median_fitness = 0;
+		int32_t worst_fitness = 0;
+		double seconds = 0;
+
+		//The champion and the game to replay
+		int32_t champion_id = 0;
+		uint32_t game_seed = 0;
+		int32_t turn_limit = 0;
+		int32_t map_x = 0;
+		int32_t map_y = 0;
+		//The planner settings the champion played with, see genome
+		int32_t beam_width = 0;
+		int32_t beam_depth = 0;
+		int32_t mcts_simulations = 0;
+		int32_t mcts_rollout_depth = 0;
+		int32_t mcts_food_samples = 0;
+		int32_t gene_count = 0;
+		float genes[MAX_GENES] = {};
+};
+
+//A slot of the ring. Its sequence is odd while the slot is being written,
+//so a reader that sees the same even sequence before and after copying the
+//frame knows the copy is whole. The writer never waits for readers.
+class snapshot_slot
+{
+	public:
+		atomic<uint64_t> sequence;
+		snapshot_frame frame;
+};
+
+//The shared memory object holding the ring
+class snapshot_ring_memory
+{
+	public:
+		static const int SLOT_COUNT = 16;
+
+		char magic[8];
+		uint32_t version;
+		uint32_t frame_size;
+		//The number of frames published so far. The newest frame is in slot
+		//(published - 1) % SLOT_COUNT.
+		atomic<uint64_t> published;
+		snapshot_slot slots[SLOT_COUNT];
+};
+
+//A ring of the latest frames in a named POSIX shared memory object. One
+//process publishes and any number of viewers read.
+class snapshot_ring
+{
+	public:
+		snapshot_ring() {}
+		~snapshot_ring();
+		snapshot_ring(const snapshot_ring&) = delete;
+		snapshot_ring& operator=(const snapshot_ring&) = delete;
+
+		//Creates the shared memory object for publishing, or opens an
+		//existing one for reading. Returns false if that fails.
+		bool create(const char* name);
+		bool open(const char* name);
+
+		//Writes a frame over the oldest slot
+		void publish(const snapshot_frame& frame);
+		//Copies the newest frame. Returns false if nothing is published yet.
+		bool latest(snapshot_frame& frame);
+		//Copies frame n, counting from the first frame published. Returns
+		//false if it has been overwritten or is being written.
+		bool read(uint64_t n, snapshot_frame& frame);
+		uint64_t published();
+
+	private:
+		snapshot_ring_memory* memory = nullptr;
+		bool attach(const char* name, bool creating);
+};
+
+//Shows the newest frames of a ring. The champion's game is replayed one
+//turn per frame delay, and a new champion is picked up when the replay ends.
+class snapshot_viewer
+{
+	public:
+		//Returns false if the ring cannot be opened
+		bool run(const char* name, const int frame_delay);
+
+	private:
+		void display(snapshot_ring& ring, snapshot_frame& frame, state& s, int turn);
+};
+
+#endif /* SNAPSHOTRING_H_ */
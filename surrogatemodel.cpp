@@ -0,0 +1,55 @@
+/*
+ * surrogatemodel.cpp
+ * This file contains the function implementations for the surrogate model
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include "surrogatemodel.h"
+using namespace std;
+
+void surrogate_model::add(genome& g)
+{
+	samples.push_back(g.genes());
+	sample_fitness.push_back(g.fitness_value);
+}
+
+bool surrogate_model::ready()
+{
+	return (int)samples.size() >= NEIGHBOURS;
+}
+
+double surrogate_model::predict(genome& g)
+{
+	vector<float> genes = g.genes();
+
+	//Squared distances to every sample, keeping the nearest at the front
+	vector<pair<double, int>> distances(samples.size());
+	for(unsigned int i = 0; i < samples.size(); i++)
+	{
+		double distance = 0;
+		for(unsigned int j = 0; j < genes.size(); j++)
+		{
+			double difference = genes[j] - samples[i][j];
+			distance += difference * difference;
+		}
+		distances[i] = make_pair(distance, sample_fitness[i]);
+	}
+	int count = min<int>(NEIGHBOURS, distances.size());
+	partial_sort(distances.begin(), distances.begin() + count, distances.end());
+
+	//A sample with the same genes is the prediction
+	if(distances[0].first == 0)
+		return distances[0].second;
+
+	double weight_total = 0;
+	double fitness_total = 0;
+	for(int i = 0; i < count; i++)
+	{
+		double weight = 1 / sqrt(distances[i].first);
+		weight_total += weight;
+		fitness_total += weight * distances[i].second;
+	}
+	return fitness_total / weight_total;
+}
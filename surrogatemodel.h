@@ -0,0 +1,34 @@
+/*
+ * surrogatemodel.h
+ * This file contains the header information for the surrogate model which
+ * predicts a genome's fitness from its genes without playing games
+ */
+
+#include <vector>
+#include "evolutionaryframework.h"
+using namespace std;
+
+#ifndef SURROGATEMODEL_H_
+#define SURROGATEMODEL_H_
+
+//A k nearest neighbour model of fitness over gene vectors. Every genome
+//that plays its fitness games becomes a sample, and a prediction is the
+//mean fitness of the nearest samples weighted by inverse distance.
+class surrogate_model
+{
+	public:
+		//The number of neighbours a prediction is made from
+		int NEIGHBOURS = 5;
+
+		vector<vector<float>> samples;
+		vector<int> sample_fitness;
+
+		//Adds a genome and its measured fitness
+		void add(genome& g);
+		//Returns true once there are enough samples to predict from
+		bool ready();
+		//Predicts the fitness of a genome
+		double predict(genome& g);
+};
+
+#endif /* SURROGATEMODEL_H_ */
@@ -0,0 +1,170 @@
+/*
+ * sweep.cpp
+ * This file contains the function implementations for the sweep class
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "evolutionaryframework.h"
+#include "scheduler.h"
+#include "sweep.h"
+using namespace std;
+
+//Reads each setting's comma separated values. Single values become part of
+//the base settings and lists become swept settings.
+bool sweep::load_from_file(const char* file_name)
+{
+	ifstream file;
+	file.open(file_name);
+	if(!file.is_open())
+	{
+		cout << "Failed to load sweep in " << file_name << endl;
+		return false;
+	}
+
+	string line;
+	string name;
+	string value;
+	while(getline(file, line))
+	{
+		if(!split_setting(line, name, value))
+			continue;
+
+		vector<string> values;
+		stringstream list(value);
+		string item;
+		while(getline(list, item, ','))
+		{
+			item.erase(0, item.find_first_not_of(" \t"));
+			item.erase(item.find_last_not_of(" \t") + 1);
+			run_config check;
+			if(!check.set(name, item))
+			{
+				cout << "Invalid sweep setting: " << line << endl;
+				return false;
+			}
+			values.push_back(item);
+		}
+
+		if(values.size() == 1)
+		{
+			base.set(name, values[0]);
+		}
+		//The map size is shared by the whole process, so it cannot vary
+		else if(name == "MAP_X_LIMIT" || name == "MAP_Y_LIMIT" || name == "THREADS")
+		{
+			cout << name << " cannot be swept" << endl;
+			return false;
+		}
+		else if(!values.empty())
+		{
+			swept_names.push_back(name);
+			swept_values.push_back(values);
+		}
+	}
+	return true;
+}
+
+//Counts through the combinations like an odometer, with the last swept
+//setting changing fastest
+vector<run_config> sweep::configurations()
+{
+	vector<run_config> configs;
+	vector<unsigned int> position(swept_names.size(), 0);
+	while(true)
+	{
+		run_config config = base;
+		for(unsigned int i = 0; i < swept_names.size(); i++)
+		{
+			config.set(swept_names[i], swept_values[i][position[i]]);
+		}
+		configs.push_back(config);
+
+		int i = swept_names.size() - 1;
+		while(i >= 0 && ++position[i] == swept_values[i].size())
+		{
+			position[i] = 0;
+			i--;
+		}
+		if(i < 0)
+			return configs;
+	}
+}
+
+//Each driver thread takes the next configuration and evolves it. The
+//drivers only queue games and wait, so the shared pool's workers do all of
+//the computation and no run can take more than its share of the threads.
+void sweep::run()
+{
+	vector<run_config> configs = configurations();
+	shared_ptr<scheduler> pool = make_shared<scheduler>(base.THREADS);
+	results.assign(configs.size(), sweep_result());
+
+	atomic<unsigned int> next_config{0};
+	atomic<unsigned int> finished{0};
+	mutex output_lock;
+	auto drive = [&]()
+	{
+		unsigned int index;
+		while((index = next_config++) < configs.size())
+		{
+			chrono::steady_clock::time_point start = chrono::steady_clock::now();
+			evolution run_e(configs[index], pool);
+			run_e.verbose = false;
+			run_e.run();
+
+			sweep_result& result = results[index];
+			result.config = configs[index];
+			result.best_fitness = run_e.generation.back().fitness_value;
+			result.median_fitness = run_e.generation[run_e.generation.size() / 2].fitness_value;
+			result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+			lock_guard<mutex> guard(output_lock);
+			cout << "Finished run " << index + 1 << " (" << ++finished << "/" << configs.size() << ")" << endl;
+		}
+	};
+
+	unsigned int driver_count = min<unsigned int>(configs.size(), pool->size());
+	vector<thread> drivers;
+	for(unsigned int i = 0; i < driver_count; i++)
+	{
+		drivers.push_back(thread(drive));
+	}
+	for(unsigned int i = 0; i < drivers.size(); i++)
+	{
+		drivers[i].join();
+	}
+
+	display();
+}
+
+//Prints one row per run with its swept settings and results
+void sweep::display()
+{
+	cout << left << setw(6) << "Run";
+	for(unsigned int i = 0; i < swept_names.size(); i++)
+	{
+		cout << setw(max<int>(swept_names[i].size() + 2, 10)) << swept_names[i];
+	}
+	cout << setw(14) << "Best Fitness" << setw(16) << "Median Fitness" << "Seconds" << endl;
+
+	for(unsigned int run = 0; run < results.size(); run++)
+	{
+		cout << setw(6) << run + 1;
+		for(unsigned int i = 0; i < swept_names.size(); i++)
+		{
+			cout << setw(max<int>(swept_names[i].size() + 2, 10)) << results[run].config.get(swept_names[i]);
+		}
+		cout << setw(14) << results[run].best_fitness << setw(16) << results[run].median_fitness
+			 << fixed << setprecision(1) << results[run].seconds << endl;
+		cout.unsetf(ios::fixed);
+	}
+	cout << right;
+}
@@ -0,0 +1,53 @@
+/*
+ * sweep.h
+ * This file contains the header information for the sweep class which runs
+ * a grid of evolution settings side by side
+ */
+
+#include <string>
+#include <vector>
+#include "runconfig.h"
+using namespace std;
+
+#ifndef SWEEP_H_
+#define SWEEP_H_
+
+//The outcome of one run of a sweep
+class sweep_result
+{
+	public:
+		run_config config;
+		int best_fitness = 0;
+		int median_fitness = 0;
+		double seconds = 0;
+};
+
+//A sweep file uses the settings file format, where a setting may list
+//several comma separated values. Every combination of the listed values is
+//evolved as its own run. The runs share one worker pool sized to THREADS,
+//so the whole grid is spread over the processors without oversubscribing.
+class sweep
+{
+	public:
+		//Settings shared by every run
+		run_config base;
+		//The settings with more than one value, and their values
+		vector<string> swept_names;
+		vector<vector<string>> swept_values;
+
+		vector<sweep_result> results;
+
+		//Reads a sweep file on top of the base settings. Returns false if the
+		//file cannot be read or a value is invalid.
+		bool load_from_file(const char* file_name);
+
+		//Returns the settings of every combination of swept values
+		vector<run_config> configurations();
+
+		//Evolves every configuration, keeping up to one run per worker thread
+		//in flight, and then prints the results table
+		void run();
+		void display();
+};
+
+#endif /* SWEEP_H_ */
@@ -0,0 +1,143 @@
+/*
+ * tournament.cpp
+ * This file contains the function implementations for the tournament class
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include "genomelibrary.h"
+#include "scheduler.h"
+#include "tournament.h"
+using namespace std;
+
+//Returns the value below which the given percent of the sorted values fall,
+//using the nearest rank
+static int percentile(vector<int> values, int percent)
+{
+	sort(values.begin(), values.end());
+	int rank = (percent * (int)values.size() + 99) / 100;
+	return values[max(rank - 1, 0)];
+}
+
+static double mean(const vector<int>& values)
+{
+	double total = 0;
+	for(unsigned int i = 0; i < values.size(); i++)
+	{
+		total += values[i];
+	}
+	return total / values.size();
+}
+
+bool tournament::add_file(const char* file_name)
+{
+	if(genome_library::is_library(file_name))
+	{
+		genome_library library;
+		if(!library.open(file_name))
+			return false;
+		vector<genome> best = library.best(LIBRARY_ENTRANTS);
+		for(unsigned int i = 0; i < best.size(); i++)
+		{
+			names.push_back(string(file_name) + "#" + to_string(i + 1));
+			entrants.push_back(best[i]);
+		}
+		return true;
+	}
+
+	genome entrant;
+	if(!entrant.load_from_file(file_name))
+		return false;
+	names.push_back(file_name);
+	entrants.push_back(entrant);
+	return true;
+}
+
+unsigned int tournament::game_seed(int i)
+{
+	return SEED * 7919u + static_cast<unsigned int>(i) * 104729u + 1u;
+}
+
+void tournament::run()
+{
+	vector<vector<int>> fitness(entrants.size(), vector<int>(SEED_COUNT));
+	vector<vector<int>> scores = fitness;
+	vector<vector<int>> turns = fitness;
+
+	scheduler pool(THREADS);
+	task_group games;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for(unsigned int i = 0; i < entrants.size(); i++)
+	{
+		for(int j = 0; j < SEED_COUNT; j++)
+		{
+			unsigned int seed = game_seed(j);
+			pool.submit(games, [this, &fitness, &scores, &turns, i, j, seed]()
+			{
+				genome player = entrants[i];
+				player.BEAM_WIDTH = BEAM_WIDTH;
+				player.BEAM_DEPTH = BEAM_DEPTH;
+				player.MCTS_SIMULATIONS = MCTS_SIMULATIONS;
+				player.MCTS_ROLLOUT_DEPTH = MCTS_ROLLOUT_DEPTH;
+				player.MCTS_FOOD_SAMPLES = MCTS_FOOD_SAMPLES;
+				seed_game_rand(seed);
+				fitness[i][j] = player.play_game(false, TURN_LIMIT);
+				scores[i][j] = player.game_score;
+				turns[i][j] = player.game_turns;
+			});
+		}
+	}
+	pool.wait(games);
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	games_per_second = entrants.size() * SEED_COUNT / max(seconds, 1e-9);
+
+	results.clear();
+	for(unsigned int i = 0; i < entrants.size(); i++)
+	{
+		tournament_result result;
+		result.name = names[i];
+		result.entrant = entrants[i];
+		result.mean_fitness = mean(fitness[i]);
+		result.mean_score = mean(scores[i]);
+		result.median_score = percentile(scores[i], 50);
+		result.low_score = percentile(scores[i], LOW_PERCENTILE);
+		result.worst_score = *min_element(scores[i].begin(), scores[i].end());
+		result.mean_turns = mean(turns[i]);
+		result.median_turns = percentile(turns[i], 50);
+		result.low_turns = percentile(turns[i], LOW_PERCENTILE);
+		result.worst_turns = *min_element(turns[i].begin(), turns[i].end());
+		results.push_back(result);
+	}
+	stable_sort(results.begin(), results.end(), [](const tournament_result& a, const tournament_result& b)
+	{
+		return a.mean_fitness > b.mean_fitness;
+	});
+
+	display();
+}
+
+//Prints one row per entrant from the highest mean fitness down
+void tournament::display()
+{
+	string low = "P" + to_string(LOW_PERCENTILE);
+	cout << "Tournament of " << entrants.size() << " genomes on " << SEED_COUNT << " seeds, "
+		 << TURN_LIMIT << " turns per game" << endl;
+	cout << left << setw(6) << "Rank" << setw(12) << "Fitness"
+		 << setw(8) << "Score" << setw(8) << "Median" << setw(8) << low << setw(8) << "Worst"
+		 << setw(8) << "Turns" << setw(8) << "Median" << setw(8) << low << setw(8) << "Worst" << "Genome" << endl;
+	cout << fixed << setprecision(1);
+	for(unsigned int i = 0; i < results.size(); i++)
+	{
+		tournament_result& result = results[i];
+		cout << setw(6) << i + 1 << setw(12) << result.mean_fitness
+			 << setw(8) << result.mean_score << setw(8) << result.median_score
+			 << setw(8) << result.low_score << setw(8) << result.worst_score
+			 << setw(8) << result.mean_turns << setw(8) << result.median_turns
+			 << setw(8) << result.low_turns << setw(8) << result.worst_turns << result.name << endl;
+	}
+	cout << "Games/sec: " << games_per_second << endl;
+	cout.unsetf(ios::fixed);
+	cout << right;
+}
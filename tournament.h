@@ -0,0 +1,73 @@
+/*
+ * tournament.h
+ * This file contains the header information for the tournament class which
+ * ranks saved genomes by playing them on a shared set of seeds
+ */
+
+#include <string>
+#include <vector>
+#include "evolutionaryframework.h"
+using namespace std;
+
+#ifndef TOURNAMENT_H_
+#define TOURNAMENT_H_
+
+//The games of one entrant summarized over every seed
+class tournament_result
+{
+	public:
+		string name;
+		genome entrant;
+		double mean_fitness = 0;
+		double mean_score = 0;
+		int median_score = 0;
+		int low_score = 0;
+		int worst_score = 0;
+		double mean_turns = 0;
+		int median_turns = 0;
+		int low_turns = 0;
+		int worst_turns = 0;
+};
+
+//A tournament plays every entrant on the same SEED_COUNT games, so
+//entrants are compared on identical food sequences. Every game is a
+//separate task on one worker pool.
+class tournament
+{
+	public:
+		int SEED_COUNT = 20;
+		int TURN_LIMIT = 500;
+		//The planner settings every entrant plays with, see genome
+		int BEAM_WIDTH = 0;
+		int BEAM_DEPTH = 12;
+		int MCTS_SIMULATIONS = 0;
+		int MCTS_ROLLOUT_DEPTH = 6;
+		int MCTS_FOOD_SAMPLES = 4;
+		//The games' seeds are derived from this seed
+		unsigned int SEED = 5;
+		//The number of worker threads, where zero uses every hardware thread
+		int THREADS = 0;
+		//The number of genomes taken from the top of each genome library
+		int LIBRARY_ENTRANTS = 100;
+		//The percentile reported as the low score and low turns
+		int LOW_PERCENTILE = 10;
+
+		vector<string> names;
+		vector<genome> entrants;
+		vector<tournament_result> results;
+		double games_per_second = 0;
+
+		//Adds a text genome file or the fittest genomes of a genome library.
+		//Returns false if the file cannot be read.
+		bool add_file(const char* file_name);
+
+		//Returns the seed of game i, which every entrant plays
+		unsigned int game_seed(int i);
+
+		//Plays every entrant on every seed, then ranks the entrants by their
+		//mean fitness and prints the results table
+		void run();
+		void display();
+};
+
+#endif /* TOURNAMENT_H_ */